@@ -0,0 +1,33 @@
+# 将 include/Shader 下的 *.vs / *.fs / *.gs 生成为一个头文件，每个着色器是一个 constexpr EmbeddedShader
+# 用法：cmake -DSHADER_DIR=<着色器目录> -DOUTPUT=<生成的头文件> -P EmbedShaders.cmake
+
+file(GLOB SHADER_FILES
+    ${SHADER_DIR}/*.vs
+    ${SHADER_DIR}/*.fs
+    ${SHADER_DIR}/*.gs
+)
+list(SORT SHADER_FILES)
+
+set(CONTENT "// 由 cmake/EmbedShaders.cmake 在构建时生成，请勿手动修改\n")
+string(APPEND CONTENT "#ifndef EMBEDDED_SHADERS_H\n#define EMBEDDED_SHADERS_H\n\n")
+string(APPEND CONTENT "#include \"Shader/EmbeddedShader.h\"\n\n")
+string(APPEND CONTENT "namespace EmbeddedShaders {\n\n")
+
+set(ENTRIES "")
+foreach(SHADER_FILE ${SHADER_FILES})
+    get_filename_component(SHADER_NAME ${SHADER_FILE} NAME)
+    string(MAKE_C_IDENTIFIER ${SHADER_NAME} SHADER_IDENTIFIER)
+    file(READ ${SHADER_FILE} SHADER_CODE)
+    string(APPEND CONTENT "inline constexpr EmbeddedShader ${SHADER_IDENTIFIER} { \"${SHADER_NAME}\", R\"glsl(${SHADER_CODE})glsl\" };\n\n")
+    string(APPEND ENTRIES "    ${SHADER_IDENTIFIER},\n")
+endforeach()
+
+string(APPEND CONTENT "// 全部内嵌着色器，按文件名查找\n")
+string(APPEND CONTENT "inline constexpr EmbeddedShader all[] = {\n${ENTRIES}};\n\n")
+string(APPEND CONTENT "} // namespace EmbeddedShaders\n\n#endif\n")
+
+# 内容未变化时不改写文件，避免触发不必要的重新编译
+set(TEMP_OUTPUT "${OUTPUT}.tmp")
+file(WRITE ${TEMP_OUTPUT} "${CONTENT}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${TEMP_OUTPUT} ${OUTPUT})
+file(REMOVE ${TEMP_OUTPUT})
@@ -0,0 +1,227 @@
+#ifndef ANIMATION_CLIP_H
+#define ANIMATION_CLIP_H
+
+#include <glm/glm.hpp>
+
+#include "Skeleton.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 动画片段：导入时把每个节点的关键帧按固定帧率重采样，之后采样只需两帧之间插值，不再查找关键帧
+// 每帧按分量存储（SoA）：samples[帧][分量][通道]，通道数向上补齐到 4 的倍数，
+// 同一分量的 4 个通道可以一次载入 SIMD 寄存器；补齐的通道为单位变换
+// 没有动画通道的节点在每帧都写入其绑定姿态，求值时不需要区分
+struct AnimationClip {
+    enum Component {
+        ROTATION_X, ROTATION_Y, ROTATION_Z, ROTATION_W,
+        TRANSLATION_X, TRANSLATION_Y, TRANSLATION_Z,
+        SCALE_X, SCALE_Y, SCALE_Z,
+        COMPONENT_COUNT
+    };
+
+    // 重采样前的关键帧（时间单位为秒，旋转为 xyzw 四元数）
+    struct SourceChannel {
+        std::vector<float> positionTimes;
+        std::vector<glm::vec3> positions;
+        std::vector<float> rotationTimes;
+        std::vector<glm::vec4> rotations;
+        std::vector<float> scaleTimes;
+        std::vector<glm::vec3> scales;
+
+        bool empty() const { return positions.empty() && rotations.empty() && scales.empty(); }
+        size_t keyCount() const { return positions.size() + rotations.size() + scales.size(); }
+    };
+
+    std::string name;
+    float duration = 0.0f;          // 秒
+    float sampleRate = 30.0f;       // 每秒帧数
+    uint32_t frameCount = 0;
+    uint32_t channelCount = 0;      // 等于骨架节点数
+    uint32_t stride = 0;            // 补齐到 4 的倍数后的通道数
+    std::vector<float> samples;
+
+    const float* frame(uint32_t index) const { return &samples[(size_t)index * COMPONENT_COUNT * stride]; }
+    float* frame(uint32_t index) { return &samples[(size_t)index * COMPONENT_COUNT * stride]; }
+    size_t memoryBytes() const { return samples.size() * sizeof(float); }
+
+    // 循环播放时 time 对应的两帧与插值系数
+    void locate(float time, uint32_t& frame0, uint32_t& frame1, float& alpha) const
+    {
+        float position = framePosition(time, duration, sampleRate, frameCount);
+        frame0 = std::min((uint32_t)position, frameCount > 0 ? frameCount - 1 : 0);
+        frame1 = std::min(frame0 + 1, frameCount > 0 ? frameCount - 1 : 0);
+        alpha = position - (float)frame0;
+    }
+
+    // 循环播放时 time 对应的帧位置（整数部分为帧号，小数部分为插值系数），范围 [0, frameCount - 1]
+    static float framePosition(float time, float duration, float sampleRate, uint32_t frameCount)
+    {
+        if (frameCount < 2 || duration <= 0.0f)
+            return 0.0f;
+        time = std::fmod(time, duration);
+        if (time < 0.0f)
+            time += duration;
+        return std::min(time * sampleRate, (float)(frameCount - 1));
+    }
+
+    static uint32_t paddedChannels(uint32_t channels) { return (channels + 3) & ~3u; }
+
+    // 按节点下标给出的源通道重采样，channels 为空或某项为空时使用骨架的绑定姿态
+    static AnimationClip resample(const std::string& name, float duration, const std::vector<SourceChannel>& channels,
+                                  const Skeleton& skeleton, float sampleRate = 30.0f)
+    {
+        AnimationClip clip;
+        clip.name = name;
+        clip.duration = std::max(duration, 0.0f);
+        clip.sampleRate = sampleRate;
+        clip.frameCount = std::max<uint32_t>((uint32_t)std::ceil(clip.duration * sampleRate) + 1, 2);
+        clip.channelCount = (uint32_t)skeleton.nodeCount();
+        clip.stride = paddedChannels(clip.channelCount);
+        clip.samples.assign((size_t)clip.frameCount * COMPONENT_COUNT * clip.stride, 0.0f);
+
+        for (uint32_t c = 0; c < clip.stride; c++) {
+            float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+            glm::vec3 translation(0.0f);
+            glm::vec3 scale(1.0f);
+            if (c < clip.channelCount)
+                decompose(skeleton.nodes[c].bindLocal, rotation, translation, scale);
+            const SourceChannel* source = (c < channels.size() && !channels[c].empty()) ? &channels[c] : nullptr;
+
+            for (uint32_t f = 0; f < clip.frameCount; f++) {
+                float time = std::min((float)f / sampleRate, clip.duration);
+                if (source) {
+                    if (!source->rotations.empty())
+                        sampleRotation(source->rotationTimes, source->rotations, time, rotation);
+                    if (!source->positions.empty())
+                        translation = sampleVector(source->positionTimes, source->positions, time);
+                    if (!source->scales.empty())
+                        scale = sampleVector(source->scaleTimes, source->scales, time);
+                }
+                float* data = clip.frame(f);
+                for (int k = 0; k < 4; k++)
+                    data[(ROTATION_X + k) * clip.stride + c] = rotation[k];
+                for (int k = 0; k < 3; k++) {
+                    data[(TRANSLATION_X + k) * clip.stride + c] = translation[k];
+                    data[(SCALE_X + k) * clip.stride + c] = scale[k];
+                }
+            }
+        }
+        return clip;
+    }
+
+    // 仿射矩阵分解为旋转（xyzw）、平移与缩放，不处理切变
+    static void decompose(const glm::mat4& matrix, float* rotation, glm::vec3& translation, glm::vec3& scale)
+    {
+        translation = glm::vec3(matrix[3]);
+        glm::vec3 axis[3] = { glm::vec3(matrix[0]), glm::vec3(matrix[1]), glm::vec3(matrix[2]) };
+        for (int i = 0; i < 3; i++) {
+            scale[i] = glm::length(axis[i]);
+            if (scale[i] > 0.0f)
+                axis[i] = axis[i] * (1.0f / scale[i]);
+        }
+        // 镜像变换：把负号放到缩放上，保证旋转矩阵行列式为正
+        if (glm::dot(glm::cross(axis[0], axis[1]), axis[2]) < 0.0f) {
+            scale.x = -scale.x;
+            axis[0] = -axis[0];
+        }
+
+        // Shepperd 方法：按迹与对角线最大元选择数值稳定的分支
+        float m00 = axis[0].x, m11 = axis[1].y, m22 = axis[2].z;
+        float trace = m00 + m11 + m22;
+        float x, y, z, w;
+        if (trace > 0.0f) {
+            float s = std::sqrt(trace + 1.0f) * 2.0f;
+            w = 0.25f * s;
+            x = (axis[1].z - axis[2].y) / s;
+            y = (axis[2].x - axis[0].z) / s;
+            z = (axis[0].y - axis[1].x) / s;
+        }
+        else if (m00 > m11 && m00 > m22) {
+            float s = std::sqrt(1.0f + m00 - m11 - m22) * 2.0f;
+            w = (axis[1].z - axis[2].y) / s;
+            x = 0.25f * s;
+            y = (axis[1].x + axis[0].y) / s;
+            z = (axis[2].x + axis[0].z) / s;
+        }
+        else if (m11 > m22) {
+            float s = std::sqrt(1.0f + m11 - m00 - m22) * 2.0f;
+            w = (axis[2].x - axis[0].z) / s;
+            x = (axis[1].x + axis[0].y) / s;
+            y = 0.25f * s;
+            z = (axis[2].y + axis[1].z) / s;
+        }
+        else {
+            float s = std::sqrt(1.0f + m22 - m00 - m11) * 2.0f;
+            w = (axis[0].y - axis[1].x) / s;
+            x = (axis[2].x + axis[0].z) / s;
+            y = (axis[2].y + axis[1].z) / s;
+            z = 0.25f * s;
+        }
+        float length = std::sqrt(x * x + y * y + z * z + w * w);
+        rotation[0] = x / length;
+        rotation[1] = y / length;
+        rotation[2] = z / length;
+        rotation[3] = w / length;
+    }
+
+private:
+    // 找到 time 所在的关键帧区间 [index, index + 1] 与插值系数
+    static size_t findKey(const std::vector<float>& times, float time, float& alpha)
+    {
+        alpha = 0.0f;
+        if (times.size() < 2 || time <= times.front())
+            return 0;
+        if (time >= times.back())
+            return times.size() - 1;
+        size_t index = (size_t)(std::upper_bound(times.begin(), times.end(), time) - times.begin()) - 1;
+        float span = times[index + 1] - times[index];
+        alpha = span > 0.0f ? (time - times[index]) / span : 0.0f;
+        return index;
+    }
+
+    static glm::vec3 sampleVector(const std::vector<float>& times, const std::vector<glm::vec3>& values, float time)
+    {
+        float alpha;
+        size_t index = findKey(times, time, alpha);
+        if (index + 1 >= values.size())
+            return values[std::min(index, values.size() - 1)];
+        return glm::mix(values[index], values[index + 1], alpha);
+    }
+
+    // 关键帧之间用球面插值，重采样只在导入时进行一次
+    static void sampleRotation(const std::vector<float>& times, const std::vector<glm::vec4>& values, float time, float* rotation)
+    {
+        float alpha;
+        size_t index = findKey(times, time, alpha);
+        const glm::vec4& a = values[std::min(index, values.size() - 1)];
+        if (index + 1 >= values.size() || alpha <= 0.0f) {
+            for (int k = 0; k < 4; k++)
+                rotation[k] = a[k];
+            return;
+        }
+        glm::vec4 b = values[index + 1];
+        float cosine = glm::dot(a, b);
+        if (cosine < 0.0f) {
+            b = b * -1.0f;
+            cosine = -cosine;
+        }
+        float wa = 1.0f - alpha;
+        float wb = alpha;
+        if (cosine < 0.9995f) {
+            float angle = std::acos(cosine);
+            float inverseSine = 1.0f / std::sin(angle);
+            wa = std::sin((1.0f - alpha) * angle) * inverseSine;
+            wb = std::sin(alpha * angle) * inverseSine;
+        }
+        glm::vec4 result = a * wa + b * wb;
+        float length = glm::length(result);
+        for (int k = 0; k < 4; k++)
+            rotation[k] = result[k] / length;
+    }
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef ANIMATION_CLIP_STORE_H
+#define ANIMATION_CLIP_STORE_H
+
+#include "AnimationClip.h"
+#include "CompressedClip.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+// 动画片段库：按名称查找，下标在加入后不变
+// compress() 之后片段以 CompressedClip 形式采样；releaseSamples 为 true 时释放原始帧，只保留时长等元数据
+class AnimationClipStore
+{
+public:
+    int add(AnimationClip clip)
+    {
+        int index = (int)clips_.size();
+        names_[clip.name] = index;
+        clips_.push_back(std::move(clip));
+        return index;
+    }
+
+    int find(const std::string& name) const
+    {
+        auto it = names_.find(name);
+        return it == names_.end() ? -1 : it->second;
+    }
+
+    const AnimationClip& operator[](size_t index) const { return clips_[index]; }
+    AnimationClip& operator[](size_t index) { return clips_[index]; }
+    size_t size() const { return clips_.size(); }
+    bool empty() const { return clips_.empty(); }
+
+    // 压缩所有尚未压缩的片段
+    void compress(const ClipCompressionSettings& settings = ClipCompressionSettings(), bool releaseSamples = true)
+    {
+        compressed_.resize(clips_.size());
+        for (size_t i = 0; i < clips_.size(); i++) {
+            if (compressed_[i].frameCount > 0 || clips_[i].samples.empty())
+                continue;
+            compressed_[i] = CompressedClip::compress(clips_[i], settings);
+            if (releaseSamples) {
+                clips_[i].samples.clear();
+                clips_[i].samples.shrink_to_fit();
+            }
+        }
+    }
+
+    // 片段的压缩形式，未压缩时为空
+    const CompressedClip* compressed(size_t index) const
+    {
+        return index < compressed_.size() && compressed_[index].frameCount > 0 ? &compressed_[index] : nullptr;
+    }
+
+    size_t memoryBytes() const
+    {
+        size_t bytes = 0;
+        for (const AnimationClip& clip : clips_)
+            bytes += clip.memoryBytes();
+        for (const CompressedClip& clip : compressed_)
+            bytes += clip.memoryBytes();
+        return bytes;
+    }
+
+    void printStats() const
+    {
+        for (size_t i = 0; i < clips_.size(); i++) {
+            if (const CompressedClip* clip = compressed(i))
+                clip->print();
+        }
+    }
+
+private:
+    std::vector<AnimationClip> clips_;
+    std::vector<CompressedClip> compressed_;
+    std::map<std::string, int> names_;
+};
+
+#endif
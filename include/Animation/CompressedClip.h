@@ -0,0 +1,550 @@
+#ifndef COMPRESSED_CLIP_H
+#define COMPRESSED_CLIP_H
+
+#include "AnimationClip.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define COMPRESSED_CLIP_SSE 1
+    #include <emmintrin.h>
+#endif
+
+// 关键帧删减的容差
+struct ClipCompressionSettings {
+    float rotationTolerance = 0.0005f;      // 四元数分量的最大误差（约 0.06 度）
+    float translationTolerance = 0.0001f;   // 模型空间单位
+    float scaleTolerance = 0.0001f;
+};
+
+// 压缩后的动画片段，由重采样后的 AnimationClip 生成
+// 每个节点分为旋转、平移、缩放三条轨道：
+//     整段不变（在容差内）的轨道不存关键帧，其值写入 baseFrame（一帧 SoA 布局，建立采样游标时整块拷贝）；
+//     其余轨道的关键帧量化为 6 字节：旋转为 smallest-three（2 位最大分量下标 + 3 x 15 位），
+//     平移/缩放为 3 x 16 位，按该轨道在整段中的 [min, max] 量化
+// 时间轴切成 BLOCK_FRAMES 帧一块，每块的首尾两帧总是保留，中间按容差做贪心删减（剩余帧线性插值的误差不超过容差）；
+// 一块内所有动画轨道的数据连续存放：[每条轨道的关键帧数][每条轨道的块内帧号][每条轨道的键值]，
+// 关键帧数集中在块首，各轨道的起始位置只需累加，不必等上一条轨道读完；
+// 采样时刻 t 时只读取其所在的一块，不需要二分查找；采样游标（Cursor）记住每条轨道所在的区间与已解码的两端关键帧，
+// 时间连续前进时大多数轨道只需重算插值系数，跨过关键帧时只解码新进入的一个关键帧
+struct CompressedClip {
+    static const uint32_t BLOCK_FRAMES = 16;
+    static const uint32_t KEY_BYTES = 6;
+    static const uint32_t NO_BLOCK = 0xFFFFFFFFu;
+    static const uint32_t NO_KEY = 0xFFFFFFFFu;
+
+    enum Track { ROTATION, TRANSLATION, SCALE, TRACK_COUNT };
+
+    // 有关键帧的轨道，按在块内的存放顺序排列；平移/缩放的键值 = minimum + 量化值 * step
+    // 第 4 个分量恒为 0，解码时 minimum / step 可整块读入一个 SSE 寄存器
+    struct AnimatedTrack {
+        uint32_t channel = 0;
+        uint32_t track = ROTATION;
+        uint32_t component = 0;                 // 第一个分量在一帧中的下标：分量行 * stride + channel
+        uint32_t weight = 0;                    // 插值系数在 Cursor::weights 中的下标：track * stride + channel
+        float minimum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float step[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    };
+
+    // 一条动画轨道在当前块内的位置：当前区间为块内帧位置 [start, end)，末区间的 end 为无穷大
+    struct TrackCursor {
+        uint32_t frames = 0;                    // 本块内该轨道的帧号在 data 中的偏移
+        uint32_t keys = 0;                      // 本块内该轨道的键值在 data 中的偏移
+        uint32_t count = 0;
+        uint32_t key = NO_KEY;                  // 当前区间前端关键帧在块内的序号
+        float start = 0.0f;
+        float end = 0.0f;
+        float inverseSpan = 0.0f;
+    };
+
+    // 待解码的一个关键帧，out 指向 frameA 或 frameB 中该轨道的第一个分量
+    struct KeyJob {
+        const uint8_t* key;
+        const AnimatedTrack* info;
+        float* out;
+    };
+
+    // 采样游标，由调用方持有（PoseEvaluator 每个线程每个片段一份），不能在线程间共享
+    // frameA / frameB 为当前区间两端的关键帧，布局与 AnimationClip 的一帧相同；常量轨道与补齐通道在游标建立时从 baseFrame 填入，之后不再改写
+    // weights[track * stride + c] 为通道 c 的该轨道的插值系数（常量轨道与补齐通道为 0）
+    struct Cursor {
+        const CompressedClip* clip = nullptr;
+        const uint8_t* data = nullptr;
+        uint32_t block = NO_BLOCK;
+        std::vector<float> frameA;
+        std::vector<float> frameB;
+        std::vector<float> weights;
+        std::vector<TrackCursor> tracks;
+        std::vector<KeyJob> rotationKeys;       // 本次采样待解码的关键帧，容量为轨道数的两倍
+        std::vector<KeyJob> vectorKeys;
+        size_t rotationCount = 0;
+        size_t vectorCount = 0;
+    };
+
+    std::string name;
+    float duration = 0.0f;
+    float sampleRate = 30.0f;
+    uint32_t frameCount = 0;
+    uint32_t channelCount = 0;
+    uint32_t stride = 0;
+    uint32_t blockCount = 0;
+    std::vector<float> baseFrame;               // 常量轨道的值与补齐通道的单位变换，COMPONENT_COUNT * stride
+    std::vector<AnimatedTrack> animatedTracks;
+    std::vector<uint32_t> blockOffsets;         // 每块在 data 中的起始字节
+    std::vector<uint8_t> data;
+
+    size_t rawBytes = 0;                        // 压缩前（AnimationClip::samples）的大小
+    size_t sourceKeys = 0;                      // 压缩前动画轨道的关键帧数
+    size_t storedKeys = 0;                      // 删减后保留的关键帧数
+
+    size_t memoryBytes() const
+    {
+        return baseFrame.size() * sizeof(float) + animatedTracks.size() * sizeof(AnimatedTrack)
+             + blockOffsets.size() * sizeof(uint32_t) + data.size();
+    }
+
+    static CompressedClip compress(const AnimationClip& clip, const ClipCompressionSettings& settings = ClipCompressionSettings())
+    {
+        CompressedClip result;
+        result.name = clip.name;
+        result.duration = clip.duration;
+        result.sampleRate = clip.sampleRate;
+        result.frameCount = clip.frameCount;
+        result.channelCount = clip.channelCount;
+        result.stride = clip.stride;
+        result.rawBytes = clip.memoryBytes();
+        result.blockCount = std::max<uint32_t>((clip.frameCount - 1 + BLOCK_FRAMES - 1) / BLOCK_FRAMES, 1);
+        if (clip.samples.empty())
+            return result;
+        result.baseFrame.assign(clip.frame(0), clip.frame(0) + (size_t)AnimationClip::COMPONENT_COUNT * clip.stride);
+
+        // 每条动画轨道量化后的关键帧与解码值（删减时用解码值做端点，误差检查包含量化误差）
+        struct Encoded {
+            std::vector<uint8_t> keys;
+            std::vector<float> decoded;         // 每帧 4 个 float
+        };
+        std::vector<Encoded> encoded;
+        std::vector<float> values((size_t)clip.frameCount * 4);
+
+        for (uint32_t c = 0; c < clip.channelCount; c++) {
+            for (uint32_t track = 0; track < TRACK_COUNT; track++) {
+                float tolerance = trackTolerance(settings, track);
+                for (uint32_t f = 0; f < clip.frameCount; f++)
+                    read(clip, f, c, track, &values[(size_t)f * 4]);
+
+                bool constant = true;
+                for (uint32_t f = 1; f < clip.frameCount && constant; f++)
+                    constant = difference(&values[0], &values[(size_t)f * 4], track) <= tolerance;
+                if (constant)
+                    continue;
+
+                AnimatedTrack info;
+                info.channel = c;
+                info.track = track;
+                info.component = firstComponent(track) * clip.stride + c;
+                info.weight = track * clip.stride + c;
+                if (track != ROTATION) {
+                    for (int k = 0; k < 3; k++) {
+                        float minimum = values[k], maximum = values[k];
+                        for (uint32_t f = 1; f < clip.frameCount; f++) {
+                            minimum = std::min(minimum, values[(size_t)f * 4 + k]);
+                            maximum = std::max(maximum, values[(size_t)f * 4 + k]);
+                        }
+                        info.minimum[k] = minimum;
+                        info.step[k] = (maximum - minimum) / 65535.0f;
+                    }
+                }
+
+                Encoded stream;
+                stream.keys.resize((size_t)clip.frameCount * KEY_BYTES);
+                stream.decoded.resize((size_t)clip.frameCount * 4);
+                for (uint32_t f = 0; f < clip.frameCount; f++) {
+                    uint8_t* key = &stream.keys[(size_t)f * KEY_BYTES];
+                    if (track == ROTATION)
+                        encodeRotation(&values[(size_t)f * 4], key);
+                    else
+                        encodeVector(&values[(size_t)f * 4], info, key);
+                    decodeKey(key, info, &stream.decoded[(size_t)f * 4]);
+                }
+                result.animatedTracks.push_back(info);
+                encoded.push_back(std::move(stream));
+                result.sourceKeys += clip.frameCount;
+            }
+        }
+
+        // 逐块写出：块 b 覆盖帧 [b * BLOCK_FRAMES, b * BLOCK_FRAMES + span]，与下一块共享边界帧
+        size_t trackCount = result.animatedTracks.size();
+        std::vector<std::vector<uint32_t>> kept(trackCount);
+        for (uint32_t b = 0; b < result.blockCount; b++) {
+            uint32_t first = b * BLOCK_FRAMES;
+            uint32_t span = std::min(BLOCK_FRAMES, clip.frameCount - 1 - first);
+            for (size_t t = 0; t < trackCount; t++) {
+                const AnimatedTrack& info = result.animatedTracks[t];
+                for (uint32_t f = 0; f <= span; f++)
+                    read(clip, first + f, info.channel, info.track, &values[(size_t)f * 4]);
+                reduceKeys(encoded[t].decoded.data() + (size_t)first * 4, values.data(), span, info.track,
+                           trackTolerance(settings, info.track), kept[t]);
+                result.storedKeys += kept[t].size();
+            }
+
+            result.blockOffsets.push_back((uint32_t)result.data.size());
+            for (size_t t = 0; t < trackCount; t++)
+                result.data.push_back((uint8_t)kept[t].size());
+            for (size_t t = 0; t < trackCount; t++)
+                for (uint32_t frame : kept[t])
+                    result.data.push_back((uint8_t)frame);
+            for (size_t t = 0; t < trackCount; t++) {
+                for (uint32_t frame : kept[t]) {
+                    const uint8_t* key = &encoded[t].keys[(size_t)(first + frame) * KEY_BYTES];
+                    result.data.insert(result.data.end(), key, key + KEY_BYTES);
+                }
+            }
+        }
+        result.data.shrink_to_fit();
+        return result;
+    }
+
+    // 把 time 所在区间两端的关键帧与各轨道的插值系数更新到 cursor 中
+    // 姿态 = mix(frameA, frameB, weights)，由 PoseEvaluator 每次 4 个通道完成插值
+    void decode(float time, Cursor& cursor) const
+    {
+        if (cursor.clip != this || cursor.data != data.data())
+            reset(cursor);
+        if (animatedTracks.empty())
+            return;
+
+        float position = AnimationClip::framePosition(time, duration, sampleRate, frameCount);
+        uint32_t block = std::min((uint32_t)position / BLOCK_FRAMES, blockCount - 1);
+        float local = position - (float)(block * BLOCK_FRAMES);
+        if (block != cursor.block)
+            enterBlock(block, cursor);
+
+        cursor.rotationCount = 0;
+        cursor.vectorCount = 0;
+        for (size_t t = 0; t < animatedTracks.size(); t++) {
+            const AnimatedTrack& info = animatedTracks[t];
+            TrackCursor& track = cursor.tracks[t];
+            if (local < track.start || local >= track.end)
+                seek(info, track, local, cursor);
+            float alpha = (local - track.start) * track.inverseSpan;
+            cursor.weights[info.weight] = std::min(std::max(alpha, 0.0f), 1.0f);
+        }
+        decodeRotations(cursor.rotationKeys.data(), cursor.rotationCount);
+        decodeVectors(cursor.vectorKeys.data(), cursor.vectorCount);
+    }
+
+    void print() const
+    {
+        std::cout << "ANIMATION_CLIP:: " << name << ": " << frameCount << " frames x " << channelCount << " channels"
+                  << ", " << rawBytes / 1024.0f << " KB -> " << memoryBytes() / 1024.0f << " KB"
+                  << " (" << (memoryBytes() > 0 ? (float)rawBytes / memoryBytes() : 0.0f) << "x)"
+                  << ", animated keys kept: " << storedKeys << "/" << sourceKeys << std::endl;
+    }
+
+private:
+    static uint32_t firstComponent(uint32_t track)
+    {
+        return track == ROTATION ? AnimationClip::ROTATION_X
+             : track == TRANSLATION ? AnimationClip::TRANSLATION_X : AnimationClip::SCALE_X;
+    }
+
+    static uint32_t componentCount(uint32_t track) { return track == ROTATION ? 4 : 3; }
+
+    // 游标换到另一个片段：常量部分从 baseFrame 填入一次
+    void reset(Cursor& cursor) const
+    {
+        cursor.clip = this;
+        cursor.data = data.data();
+        cursor.block = NO_BLOCK;
+        cursor.frameA.assign(baseFrame.begin(), baseFrame.end());
+        cursor.frameA.resize((size_t)AnimationClip::COMPONENT_COUNT * stride, 0.0f);
+        cursor.frameB = cursor.frameA;
+        cursor.weights.assign((size_t)TRACK_COUNT * stride, 0.0f);
+        cursor.tracks.assign(animatedTracks.size(), TrackCursor());
+        cursor.rotationKeys.resize(animatedTracks.size() * 2);
+        cursor.vectorKeys.resize(animatedTracks.size() * 2);
+    }
+
+    // 进入新的一块：累加块首的关键帧数得到各轨道的起始位置，所有轨道的区间失效
+    void enterBlock(uint32_t block, Cursor& cursor) const
+    {
+        const uint8_t* counts = data.data() + blockOffsets[block];
+        size_t trackCount = animatedTracks.size();
+        uint32_t frames = blockOffsets[block] + (uint32_t)trackCount;
+        uint32_t keys = frames;
+        for (size_t t = 0; t < trackCount; t++)
+            keys += counts[t];
+        for (size_t t = 0; t < trackCount; t++) {
+            TrackCursor& track = cursor.tracks[t];
+            track.frames = frames;
+            track.keys = keys;
+            track.count = counts[t];
+            track.key = NO_KEY;
+            track.start = std::numeric_limits<float>::infinity();
+            track.end = 0.0f;
+            frames += counts[t];
+            keys += counts[t] * KEY_BYTES;
+        }
+        cursor.block = block;
+    }
+
+    // 找到 local 所在的区间并登记需要解码的关键帧；时间前进时从当前区间向后找，
+    // 只前进一个区间时原来的后端帧直接作为新的前端帧
+    void seek(const AnimatedTrack& info, TrackCursor& track, float local, Cursor& cursor) const
+    {
+        const uint8_t* frames = data.data() + track.frames;
+        uint32_t k = track.key != NO_KEY && local >= track.start ? track.key : 0;
+        while (k + 2 < track.count && frames[k + 1] <= local)
+            k++;
+
+        const uint8_t* keys = data.data() + track.keys;
+        float* a = cursor.frameA.data() + info.component;
+        float* b = cursor.frameB.data() + info.component;
+        KeyJob* jobs = info.track == ROTATION ? cursor.rotationKeys.data() : cursor.vectorKeys.data();
+        size_t& count = info.track == ROTATION ? cursor.rotationCount : cursor.vectorCount;
+        if (track.key != NO_KEY && k == track.key + 1) {
+            for (uint32_t i = 0; i < componentCount(info.track); i++)
+                a[i * stride] = b[i * stride];
+        } else {
+            jobs[count++] = { keys + k * KEY_BYTES, &info, a };
+        }
+        jobs[count++] = { keys + (k + 1) * KEY_BYTES, &info, b };
+
+        track.key = k;
+        track.start = frames[k];
+        track.end = k + 2 < track.count ? (float)frames[k + 1] : std::numeric_limits<float>::infinity();
+        track.inverseSpan = 1.0f / (float)(frames[k + 1] - frames[k]);
+    }
+
+    // 旋转关键帧每 4 个一组反量化：4 个关键帧各占一个 lane，与 PoseEvaluator 的 nlerp 相同的 SoA 方式；
+    // 不足 4 个时重复最后一个补齐
+    void decodeRotations(const KeyJob* jobs, size_t count) const
+    {
+#ifdef COMPRESSED_CLIP_SSE
+        const __m128 scale = _mm_set1_ps(2.0f / 32767.0f / 1.41421356f);
+        const __m128 bias = _mm_set1_ps(1.0f / 1.41421356f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128i mask = _mm_set1_epi32(0x7FFF);
+        for (size_t i = 0; i < count; i += 4) {
+            // 每个关键帧的 48 位占一个 64 位 lane；c、b 与 a 的低位在低 32 位，a 与最大分量下标在右移 30 位后的低 32 位
+            __m128i keys01 = _mm_set_epi64x((long long)readBits(jobs[std::min(i + 1, count - 1)].key),
+                                            (long long)readBits(jobs[i].key));
+            __m128i keys23 = _mm_set_epi64x((long long)readBits(jobs[std::min(i + 3, count - 1)].key),
+                                            (long long)readBits(jobs[std::min(i + 2, count - 1)].key));
+            __m128i low = lowHalves(keys01, keys23);
+            __m128i high = lowHalves(_mm_srli_epi64(keys01, 30), _mm_srli_epi64(keys23, 30));
+            __m128 a = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(high, mask)), scale), bias);
+            __m128 b = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(low, 15), mask)), scale), bias);
+            __m128 c = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(low, mask)), scale), bias);
+            __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)), _mm_mul_ps(c, c));
+            __m128 w = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(one, lengthSquared), zero));
+
+            // 按最大分量下标把 a/b/c 依次放回其余三个位置
+            __m128i largest = _mm_srli_epi32(high, 15);
+            __m128 is0 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_setzero_si128()));
+            __m128 is1 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(1)));
+            __m128 is2 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(2)));
+            __m128 is3 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(3)));
+            float q[4][4];
+            _mm_storeu_ps(q[0], select(is0, w, a));
+            _mm_storeu_ps(q[1], select(is0, a, select(is1, w, b)));
+            _mm_storeu_ps(q[2], select(is3, c, select(is2, w, b)));
+            _mm_storeu_ps(q[3], select(is3, w, c));
+            for (size_t j = 0; j < 4 && i + j < count; j++) {
+                float* out = jobs[i + j].out;
+                out[0] = q[0][j];
+                out[stride] = q[1][j];
+                out[2 * stride] = q[2][j];
+                out[3 * stride] = q[3][j];
+            }
+        }
+#else
+        for (size_t i = 0; i < count; i++) {
+            float value[4];
+            decodeKey(jobs[i].key, *jobs[i].info, value);
+            for (uint32_t k = 0; k < 4; k++)
+                jobs[i].out[k * stride] = value[k];
+        }
+#endif
+    }
+
+    // 平移/缩放关键帧：3 个分量占一个向量的前 3 个 lane
+    void decodeVectors(const KeyJob* jobs, size_t count) const
+    {
+        for (size_t i = 0; i < count; i++) {
+            float value[4];
+#ifdef COMPRESSED_CLIP_SSE
+            uint64_t bits = readBits(jobs[i].key);
+            __m128i quantized = _mm_set_epi32(0, (int)(bits >> 32) & 0xFFFF, (int)(bits >> 16) & 0xFFFF, (int)bits & 0xFFFF);
+            _mm_storeu_ps(value, _mm_add_ps(_mm_loadu_ps(jobs[i].info->minimum),
+                                            _mm_mul_ps(_mm_cvtepi32_ps(quantized), _mm_loadu_ps(jobs[i].info->step))));
+#else
+            decodeKey(jobs[i].key, *jobs[i].info, value);
+#endif
+            for (uint32_t k = 0; k < 3; k++)
+                jobs[i].out[k * stride] = value[k];
+        }
+    }
+
+#ifdef COMPRESSED_CLIP_SSE
+    // 两个向量中 4 个 64 位 lane 的低 32 位
+    static __m128i lowHalves(__m128i a, __m128i b)
+    {
+        return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+
+    static __m128 select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+#endif
+
+    static float trackTolerance(const ClipCompressionSettings& settings, uint32_t track)
+    {
+        return track == ROTATION ? settings.rotationTolerance
+             : track == TRANSLATION ? settings.translationTolerance : settings.scaleTolerance;
+    }
+
+    static void read(const AnimationClip& clip, uint32_t frame, uint32_t channel, uint32_t track, float* out)
+    {
+        const float* data = clip.frame(frame);
+        uint32_t first = firstComponent(track);
+        for (uint32_t k = 0; k < 4; k++)
+            out[k] = k < componentCount(track) ? data[(first + k) * clip.stride + channel] : 0.0f;
+    }
+
+    // 分量最大误差；四元数 q 与 -q 等价，先对齐符号
+    static float difference(const float* a, const float* b, uint32_t track)
+    {
+        float sign = 1.0f;
+        if (track == ROTATION && a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0.0f)
+            sign = -1.0f;
+        float error = 0.0f;
+        for (int k = 0; k < 4; k++)
+            error = std::max(error, std::fabs(a[k] - sign * b[k]));
+        return error;
+    }
+
+    // 删减关键帧时的误差检查：旋转取最短路径后 nlerp，与 PoseEvaluator 的帧间插值一致
+    static void interpolate(const float* a, const float* b, float alpha, uint32_t track, float* out)
+    {
+        if (track != ROTATION) {
+            for (int k = 0; k < 3; k++)
+                out[k] = a[k] + (b[k] - a[k]) * alpha;
+            out[3] = 0.0f;
+            return;
+        }
+        float sign = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0.0f ? -1.0f : 1.0f;
+        float lengthSquared = 0.0f;
+        for (int k = 0; k < 4; k++) {
+            out[k] = a[k] + (sign * b[k] - a[k]) * alpha;
+            lengthSquared += out[k] * out[k];
+        }
+        float inverseLength = 1.0f / std::sqrt(lengthSquared);
+        for (int k = 0; k < 4; k++)
+            out[k] *= inverseLength;
+    }
+
+    // 从 0 帧开始，每次尽量向后延伸，直到中间某帧的插值误差超过容差；末帧总是保留
+    static void reduceKeys(const float* decoded, const float* exact, uint32_t span, uint32_t track, float tolerance,
+                           std::vector<uint32_t>& kept)
+    {
+        kept.assign(1, 0);
+        uint32_t from = 0;
+        while (from < span) {
+            uint32_t to = from + 1;
+            while (to < span && fits(decoded, exact, from, to + 1, track, tolerance))
+                to++;
+            kept.push_back(to);
+            from = to;
+        }
+    }
+
+    static bool fits(const float* decoded, const float* exact, uint32_t from, uint32_t to, uint32_t track, float tolerance)
+    {
+        float interpolated[4];
+        for (uint32_t f = from + 1; f < to; f++) {
+            interpolate(decoded + (size_t)from * 4, decoded + (size_t)to * 4, (float)(f - from) / (float)(to - from), track, interpolated);
+            if (difference(exact + (size_t)f * 4, interpolated, track) > tolerance)
+                return false;
+        }
+        return true;
+    }
+
+    static void writeBits(uint64_t bits, uint8_t* key)
+    {
+        for (uint32_t i = 0; i < KEY_BYTES; i++)
+            key[i] = (uint8_t)(bits >> (8 * i));
+    }
+
+    // 展开写出，编译器可合并为一次 4 字节与一次 2 字节读取
+    static uint64_t readBits(const uint8_t* key)
+    {
+        return (uint64_t)key[0] | (uint64_t)key[1] << 8 | (uint64_t)key[2] << 16 | (uint64_t)key[3] << 24
+             | (uint64_t)key[4] << 32 | (uint64_t)key[5] << 40;
+    }
+
+    // smallest-three：丢掉绝对值最大的分量（翻转符号使其为正，解码时由单位长度还原），
+    // 其余三个分量在 [-1/√2, 1/√2] 内，各量化为 15 位
+    static void encodeRotation(const float* q, uint8_t* key)
+    {
+        int largest = 0;
+        for (int k = 1; k < 4; k++)
+            if (std::fabs(q[k]) > std::fabs(q[largest]))
+                largest = k;
+        float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+        uint64_t bits = (uint64_t)largest << 45;
+        int shift = 30;
+        for (int k = 0; k < 4; k++) {
+            if (k == largest)
+                continue;
+            float normalized = (sign * q[k] * 1.41421356f + 1.0f) * 0.5f;
+            uint32_t quantized = (uint32_t)std::lround(std::min(std::max(normalized, 0.0f), 1.0f) * 32767.0f);
+            bits |= (uint64_t)quantized << shift;
+            shift -= 15;
+        }
+        writeBits(bits, key);
+    }
+
+    static void encodeVector(const float* v, const AnimatedTrack& info, uint8_t* key)
+    {
+        uint64_t bits = 0;
+        for (int k = 0; k < 3; k++) {
+            uint32_t quantized = info.step[k] > 0.0f ? (uint32_t)std::lround((v[k] - info.minimum[k]) / info.step[k]) : 0;
+            bits |= (uint64_t)std::min<uint32_t>(quantized, 65535) << (16 * k);
+        }
+        writeBits(bits, key);
+    }
+
+    static void decodeKey(const uint8_t* key, const AnimatedTrack& info, float* out)
+    {
+        uint64_t bits = readBits(key);
+        if (info.track != ROTATION) {
+            for (int k = 0; k < 3; k++)
+                out[k] = info.minimum[k] + (float)(int)((bits >> (16 * k)) & 0xFFFF) * info.step[k];
+            out[3] = 0.0f;
+            return;
+        }
+        // 按最大分量下标把 a/b/c 依次放回其余三个位置，用选择代替按下标写数组
+        const float scale = 2.0f / 32767.0f / 1.41421356f;
+        const float bias = 1.0f / 1.41421356f;
+        int largest = (int)(bits >> 45) & 3;
+        float a = (float)(int)((bits >> 30) & 0x7FFF) * scale - bias;
+        float b = (float)(int)((bits >> 15) & 0x7FFF) * scale - bias;
+        float c = (float)(int)(bits & 0x7FFF) * scale - bias;
+        float w = std::sqrt(std::max(1.0f - a * a - b * b - c * c, 0.0f));
+        out[0] = largest == 0 ? w : a;
+        out[1] = largest == 0 ? a : (largest == 1 ? w : b);
+        out[2] = largest == 3 ? c : (largest == 2 ? w : b);
+        out[3] = largest == 3 ? w : c;
+    }
+};
+
+#endif
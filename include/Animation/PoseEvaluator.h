@@ -0,0 +1,261 @@
+#ifndef POSE_EVALUATOR_H
+#define POSE_EVALUATOR_H
+
+#include <glm/glm.hpp>
+
+#include "AnimationClip.h"
+#include "AnimationClipStore.h"
+#include "Skeleton.h"
+#include "Struct/ThreadPool.h"
+
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define POSE_EVALUATOR_SSE 1
+    #include <emmintrin.h>
+#endif
+
+// 一个动画角色的播放状态
+struct AnimationInstance {
+    int clip = 0;                   // AnimationClipStore 中的下标
+    float time = 0.0f;              // 秒，超过时长时循环
+    int blendClip = -1;             // 过渡/混合的第二个片段，-1 表示不混合
+    float blendTime = 0.0f;
+    float blendWeight = 0.0f;       // 0 只用 clip，1 只用 blendClip
+};
+
+// 姿态求值：采样 -> 混合 -> 层级变换 -> 骨骼调色板
+// 姿态与片段的一帧布局相同（AnimationClip::COMPONENT_COUNT 个分量 x stride 个通道，SoA），
+// 帧间插值与片段混合每次处理 4 个通道（SSE2，其他平台为等价的标量循环）：
+//     旋转：取最短路径后归一化线性插值（nlerp），平移与缩放：线性插值
+// 调色板每根骨骼 12 个 float，为 3x4 行主序仿射矩阵，正好是纹理缓冲中的 3 个 RGBA32F 纹素
+class PoseEvaluator
+{
+public:
+    static const unsigned int PALETTE_FLOATS_PER_BONE = 12;
+
+    PoseEvaluator(const Skeleton& skeleton, const AnimationClipStore& clips)
+        : skeleton_(skeleton), clips_(clips)
+    {
+    }
+
+    size_t paletteFloats() const { return skeleton_.boneCount() * PALETTE_FLOATS_PER_BONE; }
+
+    // 求值一个角色，palette 至少 paletteFloats() 个 float；可在多个线程中同时调用
+    void evaluate(const AnimationInstance& instance, float* palette) const
+    {
+        Scratch& scratch = threadScratch();
+        uint32_t stride = AnimationClip::paddedChannels((uint32_t)skeleton_.nodeCount());
+        scratch.pose.resize((size_t)AnimationClip::COMPONENT_COUNT * stride);
+        scratch.globals.resize(skeleton_.nodeCount());
+
+        sampleClip(instance.clip, instance.time, scratch.pose.data());
+        if (instance.blendClip >= 0 && instance.blendWeight > 0.0f) {
+            scratch.blendPose.resize(scratch.pose.size());
+            sampleClip(instance.blendClip, instance.blendTime, scratch.blendPose.data());
+            blend(scratch.pose.data(), scratch.blendPose.data(), instance.blendWeight, stride);
+        }
+        buildPalette(skeleton_, scratch.pose.data(), stride, scratch.globals.data(), palette);
+    }
+
+    // 求值所有角色，第 i 个角色的调色板从 palettes[i * paletteFloats()] 开始
+    // pool 为空时串行执行
+    void evaluateAll(const std::vector<AnimationInstance>& instances, std::vector<float>& palettes,
+                     ThreadPool* pool = &ThreadPool::instance(), size_t grain = 16) const
+    {
+        size_t floats = paletteFloats();
+        palettes.resize(instances.size() * floats);
+        auto body = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                evaluate(instances[i], palettes.data() + i * floats);
+        };
+        if (pool)
+            pool->parallelFor(instances.size(), grain, body);
+        else
+            body(0, instances.size());
+    }
+
+    // 采样片段库中的第 index 个片段；已压缩时由本线程该片段的游标给出区间两端的关键帧，再按各轨道的系数插值
+    void sampleClip(int index, float time, float* pose) const
+    {
+        const CompressedClip* compressed = clips_.compressed(index);
+        if (!compressed) {
+            sample(clips_[index], time, pose);
+            return;
+        }
+        Scratch& scratch = threadScratch();
+        if (scratch.cursors.size() <= (size_t)index)
+            scratch.cursors.resize((size_t)index + 1);
+        CompressedClip::Cursor& cursor = scratch.cursors[index];
+        compressed->decode(time, cursor);
+        interpolate(cursor.frameA.data(), cursor.frameB.data(), 0.0f, compressed->stride, pose, cursor.weights.data());
+    }
+
+    // 在两帧之间插值得到 time 处的姿态
+    static void sample(const AnimationClip& clip, float time, float* pose)
+    {
+        uint32_t frame0, frame1;
+        float alpha;
+        clip.locate(time, frame0, frame1, alpha);
+        const float* a = clip.frame(frame0);
+        const float* b = clip.frame(frame1);
+        interpolate(a, b, alpha, clip.stride, pose);
+    }
+
+    // pose = mix(pose, other, weight)，旋转取最短路径
+    static void blend(float* pose, const float* other, float weight, uint32_t stride)
+    {
+        interpolate(pose, other, weight, stride, pose);
+    }
+
+    // 按层级（父节点在前）计算每个节点的全局变换，再写出骨骼调色板
+    static void buildPalette(const Skeleton& skeleton, const float* pose, uint32_t stride, glm::mat4* globals, float* palette)
+    {
+        const float* rx = pose + AnimationClip::ROTATION_X * stride;
+        const float* ry = pose + AnimationClip::ROTATION_Y * stride;
+        const float* rz = pose + AnimationClip::ROTATION_Z * stride;
+        const float* rw = pose + AnimationClip::ROTATION_W * stride;
+        const float* tx = pose + AnimationClip::TRANSLATION_X * stride;
+        const float* ty = pose + AnimationClip::TRANSLATION_Y * stride;
+        const float* tz = pose + AnimationClip::TRANSLATION_Z * stride;
+        const float* sx = pose + AnimationClip::SCALE_X * stride;
+        const float* sy = pose + AnimationClip::SCALE_Y * stride;
+        const float* sz = pose + AnimationClip::SCALE_Z * stride;
+
+        for (size_t n = 0; n < skeleton.nodes.size(); n++) {
+            glm::mat4 local = compose(rx[n], ry[n], rz[n], rw[n], tx[n], ty[n], tz[n], sx[n], sy[n], sz[n]);
+            int parent = skeleton.nodes[n].parent;
+            globals[n] = parent >= 0 ? globals[parent] * local : local;
+        }
+
+        for (size_t b = 0; b < skeleton.boneCount(); b++) {
+            int node = skeleton.boneNodes[b];
+            glm::mat4 matrix = node >= 0 ? skeleton.globalInverse * globals[node] * skeleton.boneOffsets[b] : glm::mat4(1.0f);
+            float* out = palette + b * PALETTE_FLOATS_PER_BONE;
+            for (int row = 0; row < 3; row++)
+                for (int column = 0; column < 4; column++)
+                    out[row * 4 + column] = matrix[column][row];
+        }
+    }
+
+    // 旋转（xyzw 单位四元数）、平移与缩放合成局部矩阵：T * R * S
+    static glm::mat4 compose(float x, float y, float z, float w, float tx, float ty, float tz, float sx, float sy, float sz)
+    {
+        float xx = x * x, yy = y * y, zz = z * z;
+        float xy = x * y, xz = x * z, yz = y * z;
+        float wx = w * x, wy = w * y, wz = w * z;
+        glm::mat4 matrix(1.0f);
+        matrix[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * sx, 2.0f * (xy + wz) * sx, 2.0f * (xz - wy) * sx, 0.0f);
+        matrix[1] = glm::vec4(2.0f * (xy - wz) * sy, (1.0f - 2.0f * (xx + zz)) * sy, 2.0f * (yz + wx) * sy, 0.0f);
+        matrix[2] = glm::vec4(2.0f * (xz + wy) * sz, 2.0f * (yz - wx) * sz, (1.0f - 2.0f * (xx + yy)) * sz, 0.0f);
+        matrix[3] = glm::vec4(tx, ty, tz, 1.0f);
+        return matrix;
+    }
+
+private:
+    struct Scratch {
+        std::vector<float> pose;
+        std::vector<float> blendPose;
+        std::vector<CompressedClip::Cursor> cursors;   // 压缩片段的采样游标，按片段下标
+        std::vector<glm::mat4> globals;
+    };
+
+    const Skeleton& skeleton_;
+    const AnimationClipStore& clips_;
+
+    // 每个线程一份临时缓冲，避免每次求值分配内存
+    static Scratch& threadScratch()
+    {
+        thread_local Scratch scratch;
+        return scratch;
+    }
+
+    // out = mix(a, b, t)；out 可以与 a 相同
+    // weights 不为空时按通道取系数（旋转、平移、缩放各 stride 个，布局同 CompressedClip::Cursor），忽略 t
+    static void interpolate(const float* a, const float* b, float t, uint32_t stride, float* out, const float* weights = nullptr)
+    {
+        const float* ax = a + AnimationClip::ROTATION_X * stride;
+        const float* ay = a + AnimationClip::ROTATION_Y * stride;
+        const float* az = a + AnimationClip::ROTATION_Z * stride;
+        const float* aw = a + AnimationClip::ROTATION_W * stride;
+        const float* bx = b + AnimationClip::ROTATION_X * stride;
+        const float* by = b + AnimationClip::ROTATION_Y * stride;
+        const float* bz = b + AnimationClip::ROTATION_Z * stride;
+        const float* bw = b + AnimationClip::ROTATION_W * stride;
+        float* ox = out + AnimationClip::ROTATION_X * stride;
+        float* oy = out + AnimationClip::ROTATION_Y * stride;
+        float* oz = out + AnimationClip::ROTATION_Z * stride;
+        float* ow = out + AnimationClip::ROTATION_W * stride;
+
+        // 平移与缩放的 6 个分量在内存中连续，统一系数时合并为一段线性插值
+        const float* av = a + AnimationClip::TRANSLATION_X * stride;
+        const float* bv = b + AnimationClip::TRANSLATION_X * stride;
+        float* ov = out + AnimationClip::TRANSLATION_X * stride;
+        size_t vectorFloats = (size_t)(AnimationClip::COMPONENT_COUNT - AnimationClip::TRANSLATION_X) * stride;
+        auto vectorWeights = [weights, stride](size_t i) {
+            // 第 i 个 float 所在分量行：前 3 行为平移，后 3 行为缩放
+            return weights + (i / stride < 3 ? 1 : 2) * stride + i % stride;
+        };
+
+#ifdef POSE_EVALUATOR_SSE
+        const __m128 uniform = _mm_set1_ps(t);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        for (uint32_t c = 0; c < stride; c += 4) {
+            __m128 weight = weights ? _mm_loadu_ps(weights + c) : uniform;
+            __m128 x0 = _mm_loadu_ps(ax + c), y0 = _mm_loadu_ps(ay + c), z0 = _mm_loadu_ps(az + c), w0 = _mm_loadu_ps(aw + c);
+            __m128 x1 = _mm_loadu_ps(bx + c), y1 = _mm_loadu_ps(by + c), z1 = _mm_loadu_ps(bz + c), w1 = _mm_loadu_ps(bw + c);
+
+            // dot < 0 时翻转 b，走最短路径
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x1), _mm_mul_ps(y0, y1)),
+                                    _mm_add_ps(_mm_mul_ps(z0, z1), _mm_mul_ps(w0, w1)));
+            __m128 flip = _mm_and_ps(_mm_cmplt_ps(dot, zero), signBit);
+            x1 = _mm_xor_ps(x1, flip);
+            y1 = _mm_xor_ps(y1, flip);
+            z1 = _mm_xor_ps(z1, flip);
+            w1 = _mm_xor_ps(w1, flip);
+
+            __m128 x = _mm_add_ps(x0, _mm_mul_ps(_mm_sub_ps(x1, x0), weight));
+            __m128 y = _mm_add_ps(y0, _mm_mul_ps(_mm_sub_ps(y1, y0), weight));
+            __m128 z = _mm_add_ps(z0, _mm_mul_ps(_mm_sub_ps(z1, z0), weight));
+            __m128 w = _mm_add_ps(w0, _mm_mul_ps(_mm_sub_ps(w1, w0), weight));
+
+            __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                                              _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+            __m128 inverseLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquared));
+            _mm_storeu_ps(ox + c, _mm_mul_ps(x, inverseLength));
+            _mm_storeu_ps(oy + c, _mm_mul_ps(y, inverseLength));
+            _mm_storeu_ps(oz + c, _mm_mul_ps(z, inverseLength));
+            _mm_storeu_ps(ow + c, _mm_mul_ps(w, inverseLength));
+        }
+        for (size_t i = 0; i < vectorFloats; i += 4) {
+            __m128 weight = weights ? _mm_loadu_ps(vectorWeights(i)) : uniform;
+            __m128 v0 = _mm_loadu_ps(av + i);
+            __m128 v1 = _mm_loadu_ps(bv + i);
+            _mm_storeu_ps(ov + i, _mm_add_ps(v0, _mm_mul_ps(_mm_sub_ps(v1, v0), weight)));
+        }
+#else
+        for (uint32_t c = 0; c < stride; c++) {
+            float weight = weights ? weights[c] : t;
+            float x1 = bx[c], y1 = by[c], z1 = bz[c], w1 = bw[c];
+            if (ax[c] * x1 + ay[c] * y1 + az[c] * z1 + aw[c] * w1 < 0.0f) {
+                x1 = -x1; y1 = -y1; z1 = -z1; w1 = -w1;
+            }
+            float x = ax[c] + (x1 - ax[c]) * weight;
+            float y = ay[c] + (y1 - ay[c]) * weight;
+            float z = az[c] + (z1 - az[c]) * weight;
+            float w = aw[c] + (w1 - aw[c]) * weight;
+            float inverseLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+            ox[c] = x * inverseLength;
+            oy[c] = y * inverseLength;
+            oz[c] = z * inverseLength;
+            ow[c] = w * inverseLength;
+        }
+        for (size_t i = 0; i < vectorFloats; i++)
+            ov[i] = av[i] + (bv[i] - av[i]) * (weights ? *vectorWeights(i) : t);
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef SKELETON_H
+#define SKELETON_H
+
+#include <glm/glm.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// 骨架：场景节点层级（父节点在前）与骨骼
+// 节点 = 场景中的变换节点，动画通道按节点下标存储；骨骼 = 被网格顶点引用的节点，带逆绑定矩阵（offset）
+// 顶点的 m_BoneIDs 为骨骼下标，调色板中第 i 项 = globalInverse * 节点全局变换 * offset[i]
+struct Skeleton {
+    struct Node {
+        std::string name;
+        int parent = -1;                            // 父节点下标，根节点为 -1
+        glm::mat4 bindLocal = glm::mat4(1.0f);      // 没有动画通道时使用的局部变换
+        int bone = -1;                              // 对应的骨骼下标，不是骨骼时为 -1
+    };
+
+    std::vector<Node> nodes;
+    std::vector<glm::mat4> boneOffsets;             // 模型空间 -> 骨骼空间（逆绑定矩阵）
+    std::vector<int> boneNodes;                     // 骨骼对应的节点下标，层级中找不到时为 -1
+    std::map<std::string, int> boneIndex;           // 骨骼名 -> 骨骼下标
+    glm::mat4 globalInverse = glm::mat4(1.0f);      // 根节点变换的逆
+
+    size_t boneCount() const { return boneOffsets.size(); }
+    size_t nodeCount() const { return nodes.size(); }
+    bool empty() const { return boneOffsets.empty(); }
+
+    // 注册骨骼，同名骨骼在多个网格中出现时返回同一个下标
+    int addBone(const std::string& name, const glm::mat4& offset)
+    {
+        auto it = boneIndex.find(name);
+        if (it != boneIndex.end())
+            return it->second;
+        int index = (int)boneOffsets.size();
+        boneIndex.emplace(name, index);
+        boneOffsets.push_back(offset);
+        boneNodes.push_back(-1);
+        return index;
+    }
+
+    // 追加节点，父节点必须已经加入
+    int addNode(const std::string& name, int parent, const glm::mat4& bindLocal)
+    {
+        Node node;
+        node.name = name;
+        node.parent = parent;
+        node.bindLocal = bindLocal;
+        auto it = boneIndex.find(name);
+        if (it != boneIndex.end()) {
+            node.bone = it->second;
+            boneNodes[it->second] = (int)nodes.size();
+        }
+        nodes.push_back(node);
+        return (int)nodes.size() - 1;
+    }
+
+    int findNode(const std::string& name) const
+    {
+        for (size_t i = 0; i < nodes.size(); i++)
+            if (nodes[i].name == name)
+                return (int)i;
+        return -1;
+    }
+};
+
+// 为顶点添加一个骨骼影响：有空位（权重为 0）时直接写入，否则替换权重最小的一项
+inline void addBoneInfluence(int* boneIds, float* weights, int bone, float weight, int maxInfluence)
+{
+    int slot = 0;
+    for (int i = 1; i < maxInfluence; i++) {
+        if (weights[i] < weights[slot])
+            slot = i;
+    }
+    if (weights[slot] >= weight)
+        return;
+    boneIds[slot] = bone;
+    weights[slot] = weight;
+}
+
+// 权重归一化，丢弃多余影响后总和不再为 1
+inline void normalizeBoneWeights(float* weights, int maxInfluence)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < maxInfluence; i++)
+        sum += weights[i];
+    if (sum <= 0.0f)
+        return;
+    for (int i = 0; i < maxInfluence; i++)
+        weights[i] /= sum;
+}
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef BONE_PALETTE_BUFFER_H
+#define BONE_PALETTE_BUFFER_H
+
+#include <glad/glad.h>
+
+#include "GLStateCache.h"
+#include "Shader/Shader.h"
+
+#include <algorithm>
+#include <iostream>
+
+// 所有动画角色的骨骼调色板，每帧整体上传一次
+// 数据放在纹理缓冲（GL_TEXTURE_BUFFER，RGBA32F）中：每根骨骼 3 个纹素，为 3x4 行主序仿射矩阵
+// 不用 uniform 缓冲是因为 UBO 单次绑定通常只有 64KB（约 1300 根骨骼），上千个角色的调色板放不下
+// 上传方式与 UniformRing 的回退模式相同：glBufferData(NULL) 孤立旧存储后 glBufferSubData，不等待 GPU 读完上一帧
+// 着色器（skinning.vs）中：
+//     uniform samplerBuffer bonePalette;  uniform int paletteOffset;  // 本角色第一根骨骼在调色板中的下标
+class BonePaletteBuffer
+{
+public:
+    static const unsigned int TEXELS_PER_BONE = 3;
+    static const unsigned int BYTES_PER_BONE = TEXELS_PER_BONE * 4 * sizeof(float);
+
+    BonePaletteBuffer() = default;
+    ~BonePaletteBuffer() { destroy(); }
+
+    BonePaletteBuffer(const BonePaletteBuffer&) = delete;
+    BonePaletteBuffer& operator=(const BonePaletteBuffer&) = delete;
+
+    // capacityBones 为一帧内所有角色的骨骼总数上限，超过时 upload 自动扩容
+    bool init(size_t capacityBones)
+    {
+        destroy();
+        GLint maxTexels = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+        maxBones_ = maxTexels > 0 ? (size_t)maxTexels / TEXELS_PER_BONE : 0;
+
+        glGenBuffers(1, &buffer_);
+        glGenTextures(1, &texture_);
+        capacityBones_ = 0;
+        reserve(capacityBones);
+
+        // 纹理引用的是缓冲对象本身，之后重新分配存储不需要再次关联
+        GLStateCache::instance().bindTexture(0, GL_TEXTURE_BUFFER, texture_);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer_);
+        return true;
+    }
+
+    // 上传 boneCount 根骨骼的调色板（每根 12 个 float）
+    bool upload(const float* palettes, size_t boneCount)
+    {
+        if (buffer_ == 0 || boneCount == 0)
+            return false;
+        if (maxBones_ > 0 && boneCount > maxBones_) {
+            if (!overflowReported_) {
+                std::cout << "ERROR::BONE_PALETTE::TOO_MANY_BONES: " << boneCount << " > GL_MAX_TEXTURE_BUFFER_SIZE / 3 = " << maxBones_ << std::endl;
+                overflowReported_ = true;
+            }
+            return false;
+        }
+        if (boneCount > capacityBones_)
+            reserve(boneCount + boneCount / 2);
+
+        GLStateCache::instance().bindBuffer(GL_TEXTURE_BUFFER, buffer_);
+        glBufferData(GL_TEXTURE_BUFFER, capacityBones_ * BYTES_PER_BONE, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, boneCount * BYTES_PER_BONE, palettes);
+        uploadedBones_ = boneCount;
+        uploadedBytes_ += boneCount * BYTES_PER_BONE;
+        uploads_++;
+        return true;
+    }
+
+    // 绑定调色板纹理并设置本角色的起始骨骼，调用前需激活着色器
+    void bind(const Shader& shader, unsigned int paletteOffset) const
+    {
+        GLint unit = shader.samplerUnit("bonePalette");
+        if (unit >= 0)
+            GLStateCache::instance().bindTexture(unit, GL_TEXTURE_BUFFER, texture_);
+        shader.setInt("paletteOffset", (int)paletteOffset);
+    }
+
+    void destroy()
+    {
+        if (texture_) {
+            glDeleteTextures(1, &texture_);
+            texture_ = 0;
+        }
+        if (buffer_) {
+            GLStateCache::instance().bufferDeleted(buffer_);
+            glDeleteBuffers(1, &buffer_);
+            buffer_ = 0;
+        }
+        capacityBones_ = 0;
+        uploadedBones_ = 0;
+    }
+
+    GLuint texture() const { return texture_; }
+    size_t capacityBones() const { return capacityBones_; }
+
+    void printStats() const
+    {
+        std::cout << "BONE_PALETTE:: " << uploadedBones_ << "/" << capacityBones_ << " bones"
+                  << " (" << uploadedBones_ * BYTES_PER_BONE / 1024.0f << " KB last frame)"
+                  << ", uploads: " << uploads_
+                  << ", total: " << uploadedBytes_ / (1024.0f * 1024.0f) << " MB" << std::endl;
+    }
+
+private:
+    GLuint buffer_ = 0;
+    GLuint texture_ = 0;
+    size_t capacityBones_ = 0;
+    size_t maxBones_ = 0;
+    size_t uploadedBones_ = 0;
+    size_t uploadedBytes_ = 0;
+    size_t uploads_ = 0;
+    bool overflowReported_ = false;
+
+    void reserve(size_t bones)
+    {
+        if (maxBones_ > 0)
+            bones = std::min(bones, maxBones_);
+        if (bones <= capacityBones_)
+            return;
+        capacityBones_ = bones;
+        GLStateCache::instance().bindBuffer(GL_TEXTURE_BUFFER, buffer_);
+        glBufferData(GL_TEXTURE_BUFFER, capacityBones_ * BYTES_PER_BONE, NULL, GL_STREAM_DRAW);
+    }
+};
+
+#endif
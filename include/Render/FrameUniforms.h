@@ -0,0 +1,27 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glm/glm.hpp>
+
+// 通过 UniformRing 上传的 uniform 块，成员顺序与 std140 布局一致，须与着色器中的声明保持同步
+
+// 每帧一次：layout (std140) uniform Matrices { mat4 projection; mat4 view; };
+struct CameraUniforms {
+    glm::mat4 projection;
+    glm::mat4 view;
+};
+
+// 每个物体一次：layout (std140) uniform Object { mat4 model; mat4 normalMatrix; };
+// std140 中 mat3 的每列按 vec4 对齐，这里用 mat4 存放法线矩阵，着色器中取 mat3(normalMatrix)
+struct ObjectUniforms {
+    glm::mat4 model;
+    glm::mat4 normalMatrix;
+};
+
+// uniform 块绑定点，创建着色器前通过 UniformBlockBindings 注册
+enum UniformBlockBinding {
+    CAMERA_BLOCK_BINDING = 0,
+    OBJECT_BLOCK_BINDING = 1
+};
+
+#endif
@@ -0,0 +1,281 @@
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include <glad/glad.h>
+
+#include <iostream>
+
+// OpenGL 影子状态：记录当前程序、VAO、各纹理单元的绑定、混合/深度/剔除状态以及缓冲绑定
+// 目标状态与当前一致时跳过对应的 GL 调用，并按帧统计实际发出与被跳过的调用数
+// 注意：绕过本类直接修改这些状态后需要调用 invalidate()，否则影子状态会与驱动不一致
+class GLStateCache
+{
+public:
+    // 每帧发出/跳过的调用统计
+    struct Stats {
+        unsigned int issued = 0;
+        unsigned int skipped = 0;
+    };
+
+    static const unsigned int MAX_TEXTURE_UNITS = 32;
+
+    static GLStateCache& instance()
+    {
+        static GLStateCache cache;
+        return cache;
+    }
+
+    // 每帧开始时调用：保存上一帧的统计并清零
+    void beginFrame()
+    {
+        lastFrame_ = current_;
+        current_ = Stats();
+    }
+
+    const Stats& lastFrameStats() const { return lastFrame_; }
+
+    void printStats() const
+    {
+        unsigned int total = lastFrame_.issued + lastFrame_.skipped;
+        std::cout << "GL_STATE:: issued: " << lastFrame_.issued << ", skipped: " << lastFrame_.skipped;
+        if (total > 0)
+            std::cout << " (" << 100.0f * lastFrame_.skipped / total << "% saved)";
+        std::cout << std::endl;
+    }
+
+    // 将所有影子状态置为未知，下一次设置必然发出 GL 调用
+    void invalidate()
+    {
+        program_ = UNKNOWN;
+        vertexArray_ = UNKNOWN;
+        activeUnit_ = UNKNOWN;
+        for (unsigned int i = 0; i < MAX_TEXTURE_UNITS; i++) {
+            for (unsigned int t = 0; t < TEXTURE_TARGET_COUNT; t++)
+                textures_[i][t] = UNKNOWN;
+        }
+        for (unsigned int t = 0; t < BUFFER_TARGET_COUNT; t++)
+            buffers_[t] = UNKNOWN;
+        for (unsigned int c = 0; c < CAPABILITY_COUNT; c++)
+            capabilities_[c] = -1;
+        blendSrc_ = UNKNOWN;
+        blendDst_ = UNKNOWN;
+        depthFunc_ = UNKNOWN;
+        depthMask_ = -1;
+    }
+
+    // 程序 ------------------------------------------------------------------
+    void useProgram(GLuint program)
+    {
+        if (program_ == program) {
+            current_.skipped++;
+            return;
+        }
+        program_ = program;
+        current_.issued++;
+        glUseProgram(program);
+    }
+
+    // VAO -------------------------------------------------------------------
+    void bindVertexArray(GLuint vertexArray)
+    {
+        if (vertexArray_ == vertexArray) {
+            current_.skipped++;
+            return;
+        }
+        vertexArray_ = vertexArray;
+        current_.issued++;
+        glBindVertexArray(vertexArray);
+    }
+
+    // 缓冲 ------------------------------------------------------------------
+    // GL_ELEMENT_ARRAY_BUFFER 属于 VAO 状态，不做缓存，直接发出
+    void bindBuffer(GLenum target, GLuint buffer)
+    {
+        int index = bufferTargetIndex(target);
+        if (index >= 0) {
+            if (buffers_[index] == buffer) {
+                current_.skipped++;
+                return;
+            }
+            buffers_[index] = buffer;
+        }
+        current_.issued++;
+        glBindBuffer(target, buffer);
+    }
+
+    // glBindBufferBase/Range 同时会修改通用绑定点，调用后需要同步影子状态
+    void bufferBoundIndexed(GLenum target, GLuint buffer)
+    {
+        int index = bufferTargetIndex(target);
+        if (index >= 0)
+            buffers_[index] = buffer;
+    }
+
+    // 纹理 ------------------------------------------------------------------
+    void activeTexture(GLuint unit)
+    {
+        if (activeUnit_ == unit) {
+            current_.skipped++;
+            return;
+        }
+        activeUnit_ = unit;
+        current_.issued++;
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+
+    // 绑定纹理到指定单元，仅在绑定改变时切换活动单元
+    void bindTexture(GLuint unit, GLenum target, GLuint texture)
+    {
+        int index = textureTargetIndex(target);
+        if (unit >= MAX_TEXTURE_UNITS || index < 0) {
+            activeTexture(unit);
+            current_.issued++;
+            glBindTexture(target, texture);
+            return;
+        }
+        if (textures_[unit][index] == texture) {
+            current_.skipped++;
+            return;
+        }
+        activeTexture(unit);
+        textures_[unit][index] = texture;
+        current_.issued++;
+        glBindTexture(target, texture);
+    }
+
+    // 开关状态 --------------------------------------------------------------
+    void setBlend(bool enabled)     { setCapability(BLEND, GL_BLEND, enabled); }
+    void setDepthTest(bool enabled) { setCapability(DEPTH_TEST, GL_DEPTH_TEST, enabled); }
+    void setCullFace(bool enabled)  { setCapability(CULL_FACE, GL_CULL_FACE, enabled); }
+
+    void blendFunc(GLenum src, GLenum dst)
+    {
+        if (blendSrc_ == src && blendDst_ == dst) {
+            current_.skipped++;
+            return;
+        }
+        blendSrc_ = src;
+        blendDst_ = dst;
+        current_.issued++;
+        glBlendFunc(src, dst);
+    }
+
+    void depthFunc(GLenum func)
+    {
+        if (depthFunc_ == func) {
+            current_.skipped++;
+            return;
+        }
+        depthFunc_ = func;
+        current_.issued++;
+        glDepthFunc(func);
+    }
+
+    void depthMask(bool enabled)
+    {
+        int value = enabled ? 1 : 0;
+        if (depthMask_ == value) {
+            current_.skipped++;
+            return;
+        }
+        depthMask_ = value;
+        current_.issued++;
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    }
+
+    // 对象删除通知：被删除的对象若仍处于绑定状态，GL 会将绑定恢复为 0
+    // -----------------------------------------------------------------------
+    void programDeleted(GLuint program)
+    {
+        // 删除正在使用的程序不会立即解绑，保持未知即可
+        if (program_ == program)
+            program_ = UNKNOWN;
+    }
+
+    void vertexArrayDeleted(GLuint vertexArray)
+    {
+        if (vertexArray_ == vertexArray)
+            vertexArray_ = 0;
+    }
+
+    void bufferDeleted(GLuint buffer)
+    {
+        for (unsigned int t = 0; t < BUFFER_TARGET_COUNT; t++) {
+            if (buffers_[t] == buffer)
+                buffers_[t] = 0;
+        }
+    }
+
+    void textureDeleted(GLuint texture)
+    {
+        for (unsigned int i = 0; i < MAX_TEXTURE_UNITS; i++) {
+            for (unsigned int t = 0; t < TEXTURE_TARGET_COUNT; t++) {
+                if (textures_[i][t] == texture)
+                    textures_[i][t] = 0;
+            }
+        }
+    }
+
+private:
+    static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+    enum TextureTarget { TEXTURE_2D, TEXTURE_CUBE_MAP, TEXTURE_TARGET_COUNT };
+    enum BufferTarget { ARRAY_BUFFER, UNIFORM_BUFFER, DRAW_INDIRECT_BUFFER, COPY_READ_BUFFER, COPY_WRITE_BUFFER, BUFFER_TARGET_COUNT };
+    enum Capability { BLEND, DEPTH_TEST, CULL_FACE, CAPABILITY_COUNT };
+
+    GLuint program_;
+    GLuint vertexArray_;
+    GLuint activeUnit_;
+    GLuint textures_[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+    GLuint buffers_[BUFFER_TARGET_COUNT];
+    int capabilities_[CAPABILITY_COUNT];
+    GLenum blendSrc_;
+    GLenum blendDst_;
+    GLenum depthFunc_;
+    int depthMask_;
+
+    Stats current_;
+    Stats lastFrame_;
+
+    GLStateCache() { invalidate(); }
+
+    void setCapability(Capability capability, GLenum cap, bool enabled)
+    {
+        int value = enabled ? 1 : 0;
+        if (capabilities_[capability] == value) {
+            current_.skipped++;
+            return;
+        }
+        capabilities_[capability] = value;
+        current_.issued++;
+        if (enabled)
+            glEnable(cap);
+        else
+            glDisable(cap);
+    }
+
+    static int textureTargetIndex(GLenum target)
+    {
+        switch (target) {
+            case GL_TEXTURE_2D:       return TEXTURE_2D;
+            case GL_TEXTURE_CUBE_MAP: return TEXTURE_CUBE_MAP;
+            default:                  return -1;
+        }
+    }
+
+    static int bufferTargetIndex(GLenum target)
+    {
+        switch (target) {
+            case GL_ARRAY_BUFFER:         return ARRAY_BUFFER;
+            case GL_UNIFORM_BUFFER:       return UNIFORM_BUFFER;
+            case GL_COPY_READ_BUFFER:     return COPY_READ_BUFFER;
+            case GL_COPY_WRITE_BUFFER:    return COPY_WRITE_BUFFER;
+#ifdef GL_DRAW_INDIRECT_BUFFER
+            case GL_DRAW_INDIRECT_BUFFER: return DRAW_INDIRECT_BUFFER;
+#endif
+            default:                      return -1;
+        }
+    }
+};
+
+#endif
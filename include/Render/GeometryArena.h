@@ -0,0 +1,471 @@
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+
+#include <glad/glad.h>
+
+#include "GLStateCache.h"
+#include "Struct/VertexLayout.h"
+#include "Struct/IndexFormat.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <vector>
+
+// 区间分配器：按偏移有序的空闲链表，首次适配，释放时与相邻空闲块合并
+// 单位由使用者决定（顶点池以顶点为单位，索引池以字节为单位）
+class RangeAllocator
+{
+public:
+    static const size_t INVALID = ~(size_t)0;
+
+    void reset(size_t capacity)
+    {
+        free_.clear();
+        capacity_ = capacity;
+        used_ = 0;
+        if (capacity > 0)
+            free_[0] = capacity;
+    }
+
+    // 扩容：新增的尾部区间并入空闲链表
+    void grow(size_t capacity)
+    {
+        if (capacity <= capacity_)
+            return;
+        size_t extra = capacity - capacity_;
+        used_ += extra;                     // 先记为已用，再按释放处理，与尾部空闲块合并
+        release(capacity_, extra);
+        capacity_ = capacity;
+    }
+
+    // 返回起始偏移，空间不足时返回 INVALID
+    size_t allocate(size_t size, size_t alignment = 1)
+    {
+        if (size == 0)
+            return INVALID;
+        for (auto it = free_.begin(); it != free_.end(); ++it) {
+            size_t blockOffset = it->first;
+            size_t blockSize = it->second;
+            size_t offset = (blockOffset + alignment - 1) / alignment * alignment;
+            if (offset + size > blockOffset + blockSize)
+                continue;
+
+            free_.erase(it);
+            if (offset > blockOffset)
+                free_[blockOffset] = offset - blockOffset;
+            if (offset + size < blockOffset + blockSize)
+                free_[offset + size] = blockOffset + blockSize - (offset + size);
+            used_ += size;
+            return offset;
+        }
+        return INVALID;
+    }
+
+    void release(size_t offset, size_t size)
+    {
+        if (size == 0)
+            return;
+        used_ -= size;
+        auto next = free_.lower_bound(offset);
+        // 与后一个空闲块合并
+        if (next != free_.end() && offset + size == next->first) {
+            size += next->second;
+            next = free_.erase(next);
+        }
+        // 与前一个空闲块合并
+        if (next != free_.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset) {
+                prev->second += size;
+                return;
+            }
+        }
+        free_[offset] = size;
+    }
+
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return used_; }
+    size_t freeBlocks() const { return free_.size(); }
+
+    size_t largestFree() const
+    {
+        size_t largest = 0;
+        for (const auto& block : free_)
+            largest = std::max(largest, block.second);
+        return largest;
+    }
+
+    // 碎片率：1 - 最大空闲块 / 空闲总量，空闲空间全部连续时为 0
+    float fragmentation() const
+    {
+        size_t freeSize = capacity_ - used_;
+        return freeSize ? 1.0f - (float)largestFree() / freeSize : 0.0f;
+    }
+
+private:
+    std::map<size_t, size_t> free_;     // 偏移 -> 大小
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+};
+
+// 全局几何体缓冲池：所有网格的顶点与索引从少量大缓冲中子分配
+// 每种顶点布局（属性掩码 + 存储格式）一个池，池内共享一个 VAO / VBO / EBO，
+// 网格只保存 (baseVertex, firstIndex, count) 记录，用 glDrawElementsBaseVertex 绘制，
+// 同一池内连续绘制不再切换 VAO，也为后续合批（多重间接绘制）提供基础
+// 索引宽度仍按每个网格的顶点数选择，索引区间按 4 字节对齐，firstIndex 总能整除
+// 支持多重间接绘制时，每个池的 VAO 额外带一个实例属性 drawId（location = DRAW_ID_LOCATION），
+// 由命令的 baseInstance 选取，着色器可用它查找逐绘制数据；不支持时由 glVertexAttribI1ui 逐次设置
+// 注意：需要在 glfwTerminate 之前调用 destroy()
+class GeometryArena
+{
+public:
+    typedef uint32_t Handle;
+    static const Handle INVALID_HANDLE = 0xFFFFFFFFu;
+
+    static const size_t VERTEX_POOL_BYTES = 8 * 1024 * 1024;   // 新建池时顶点缓冲的初始大小
+    static const size_t INDEX_POOL_BYTES = 4 * 1024 * 1024;    // 新建池时索引缓冲的初始大小
+    static const size_t INDEX_ALIGNMENT = 4;
+    static const GLuint DRAW_ID_LOCATION = VertexLayout::ATTRIBUTE_COUNT;
+    static const GLuint MAX_DRAW_IDS = 65536;                  // drawId 的取值范围，即一个批次的网格数上限
+
+    // 一个网格在池中的区间
+    struct Range {
+        uint32_t pool = 0;
+        GLint baseVertex = 0;
+        GLsizei vertexCount = 0;
+        size_t indexOffset = 0;         // 字节偏移
+        GLsizei indexCount = 0;
+        GLenum indexType = GL_UNSIGNED_INT;
+        bool live = false;
+
+        GLuint firstIndex() const { return (GLuint)(indexOffset / IndexFormat::typeSize(indexType)); }
+        size_t indexBytes() const { return (size_t)indexCount * IndexFormat::typeSize(indexType); }
+    };
+
+    static GeometryArena& instance()
+    {
+        static GeometryArena arena;
+        return arena;
+    }
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    // glMultiDrawElementsIndirect（GL 4.3 / ARB_multi_draw_indirect）
+    static bool multiDrawSupported()
+    {
+        bool supported = false;
+#if defined(GL_VERSION_4_3)
+        supported = supported || GLAD_GL_VERSION_4_3;
+#endif
+#if defined(GL_ARB_multi_draw_indirect)
+        supported = supported || GLAD_GL_ARB_multi_draw_indirect;
+#endif
+        return supported;
+    }
+
+    // 上传已按 layout 打包的顶点数据与索引，返回记录句柄；indexBytes 返回索引实际占用
+    Handle allocate(const VertexLayout& layout, const std::vector<unsigned char>& vertexData, size_t vertexCount,
+                    const std::vector<unsigned int>& indices, size_t* indexBytes = nullptr)
+    {
+        if (vertexCount == 0 || indices.empty())
+            return INVALID_HANDLE;
+
+        uint32_t poolIndex = findPool(layout);
+        Pool& pool = pools_[poolIndex];
+        GLStateCache& state = GLStateCache::instance();
+
+        // 顶点区间（以顶点为单位）
+        size_t baseVertex = pool.vertices.allocate(vertexCount);
+        if (baseVertex == RangeAllocator::INVALID) {
+            growVertices(pool, std::max(pool.vertices.capacity() * 2, pool.vertices.capacity() + vertexCount));
+            baseVertex = pool.vertices.allocate(vertexCount);
+        }
+        state.bindBuffer(GL_ARRAY_BUFFER, pool.VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, baseVertex * pool.layout.stride, vertexCount * pool.layout.stride, vertexData.data());
+
+        // 索引区间（以字节为单位），经 GL_COPY_WRITE_BUFFER 上传，避免改动当前 VAO 的索引缓冲绑定
+        GLenum indexType = IndexFormat::chooseType(vertexCount);
+        std::vector<unsigned char> indexData = IndexFormat::pack(indices, indexType);
+        size_t indexOffset = pool.indices.allocate(indexData.size(), INDEX_ALIGNMENT);
+        if (indexOffset == RangeAllocator::INVALID) {
+            growIndices(pool, std::max(pool.indices.capacity() * 2, pool.indices.capacity() + indexData.size() + INDEX_ALIGNMENT));
+            indexOffset = pool.indices.allocate(indexData.size(), INDEX_ALIGNMENT);
+        }
+        state.bindBuffer(GL_COPY_WRITE_BUFFER, pool.EBO);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset, indexData.size(), indexData.data());
+
+        Range range;
+        range.pool = poolIndex;
+        range.baseVertex = (GLint)baseVertex;
+        range.vertexCount = (GLsizei)vertexCount;
+        range.indexOffset = indexOffset;
+        range.indexCount = (GLsizei)indices.size();
+        range.indexType = indexType;
+        range.live = true;
+        pool.rangeCount++;
+        generation_++;
+
+        if (indexBytes)
+            *indexBytes = indexData.size();
+
+        if (!freeHandles_.empty()) {
+            Handle handle = freeHandles_.back();
+            freeHandles_.pop_back();
+            ranges_[handle] = range;
+            return handle;
+        }
+        ranges_.push_back(range);
+        return (Handle)(ranges_.size() - 1);
+    }
+
+    void free(Handle handle)
+    {
+        if (!valid(handle))
+            return;
+        Range& range = ranges_[handle];
+        Pool& pool = pools_[range.pool];
+        pool.vertices.release(range.baseVertex, range.vertexCount);
+        pool.indices.release(range.indexOffset, range.indexBytes());
+        pool.rangeCount--;
+        range.live = false;
+        freeHandles_.push_back(handle);
+        generation_++;
+    }
+
+    bool valid(Handle handle) const { return handle < ranges_.size() && ranges_[handle].live; }
+    const Range& range(Handle handle) const { return ranges_[handle]; }
+    GLuint vertexArray(Handle handle) const { return pools_[ranges_[handle].pool].VAO; }
+
+    // 分配、释放或整理后递增，缓存了区间记录的批次据此判断是否需要重建
+    uint64_t generation() const { return generation_; }
+
+    // 绘制一个网格区间内的 [firstIndex, firstIndex + indexCount)（如某一级 LOD），
+    // 同一池内连续绘制时 VAO 绑定由 GLStateCache 跳过
+    void draw(Handle handle, GLsizei indexCount, GLuint firstIndex = 0) const
+    {
+        const Range& range = ranges_[handle];
+        GLStateCache::instance().bindVertexArray(pools_[range.pool].VAO);
+        size_t offset = range.indexOffset + firstIndex * IndexFormat::typeSize(range.indexType);
+        glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, range.indexType, (void*)offset, range.baseVertex);
+    }
+
+    // 碎片整理：把每个池中的存活区间按原顺序紧凑到缓冲前部，更新所有记录，句柄保持不变
+    void defragment()
+    {
+        GLStateCache& state = GLStateCache::instance();
+        for (uint32_t p = 0; p < pools_.size(); p++) {
+            Pool& pool = pools_[p];
+            if (pool.vertices.freeBlocks() <= 1 && pool.indices.freeBlocks() <= 1)
+                continue;
+
+            std::vector<Handle> live;
+            for (Handle h = 0; h < ranges_.size(); h++)
+                if (ranges_[h].live && ranges_[h].pool == p)
+                    live.push_back(h);
+
+            size_t stride = pool.layout.stride;
+            GLuint vbo = createBuffer(GL_ARRAY_BUFFER, pool.vertices.capacity() * stride);
+            GLuint ebo = createBuffer(GL_ARRAY_BUFFER, pool.indices.capacity());
+            RangeAllocator vertices, indices;
+            vertices.reset(pool.vertices.capacity());
+            indices.reset(pool.indices.capacity());
+
+            // 顶点区间
+            std::sort(live.begin(), live.end(), [this](Handle a, Handle b) { return ranges_[a].baseVertex < ranges_[b].baseVertex; });
+            state.bindBuffer(GL_COPY_READ_BUFFER, pool.VBO);
+            state.bindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+            for (Handle h : live) {
+                Range& range = ranges_[h];
+                size_t baseVertex = vertices.allocate(range.vertexCount);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                    range.baseVertex * stride, baseVertex * stride, range.vertexCount * stride);
+                range.baseVertex = (GLint)baseVertex;
+            }
+
+            // 索引区间
+            std::sort(live.begin(), live.end(), [this](Handle a, Handle b) { return ranges_[a].indexOffset < ranges_[b].indexOffset; });
+            state.bindBuffer(GL_COPY_READ_BUFFER, pool.EBO);
+            state.bindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+            for (Handle h : live) {
+                Range& range = ranges_[h];
+                size_t indexOffset = indices.allocate(range.indexBytes(), INDEX_ALIGNMENT);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, range.indexOffset, indexOffset, range.indexBytes());
+                range.indexOffset = indexOffset;
+            }
+
+            replaceVertexBuffer(pool, vbo);
+            replaceIndexBuffer(pool, ebo);
+            pool.vertices = vertices;
+            pool.indices = indices;
+            generation_++;
+        }
+    }
+
+    // 释放所有池与记录（在 glfwTerminate 之前调用）
+    void destroy()
+    {
+        GLStateCache& state = GLStateCache::instance();
+        for (Pool& pool : pools_) {
+            glDeleteBuffers(1, &pool.VBO);
+            state.bufferDeleted(pool.VBO);
+            glDeleteBuffers(1, &pool.EBO);
+            state.bufferDeleted(pool.EBO);
+            glDeleteVertexArrays(1, &pool.VAO);
+            state.vertexArrayDeleted(pool.VAO);
+        }
+        if (drawIdBuffer_) {
+            glDeleteBuffers(1, &drawIdBuffer_);
+            state.bufferDeleted(drawIdBuffer_);
+            drawIdBuffer_ = 0;
+        }
+        pools_.clear();
+        ranges_.clear();
+        freeHandles_.clear();
+        generation_++;
+    }
+
+    size_t poolCount() const { return pools_.size(); }
+
+    void printStats() const
+    {
+        for (size_t p = 0; p < pools_.size(); p++) {
+            const Pool& pool = pools_[p];
+            size_t stride = pool.layout.stride;
+            std::cout << "GEOMETRY_ARENA:: pool " << p << " stride: " << stride << " B"
+                      << ", meshes: " << pool.rangeCount
+                      << ", vertices: " << pool.vertices.used() * stride / 1024.0f << " / " << pool.vertices.capacity() * stride / 1024.0f << " KB"
+                      << " (fragmentation " << 100.0f * pool.vertices.fragmentation() << "%)"
+                      << ", indices: " << pool.indices.used() / 1024.0f << " / " << pool.indices.capacity() / 1024.0f << " KB"
+                      << " (fragmentation " << 100.0f * pool.indices.fragmentation() << "%)" << std::endl;
+        }
+    }
+
+private:
+    struct Pool {
+        VertexLayout layout;
+        GLuint VAO = 0;
+        GLuint VBO = 0;
+        GLuint EBO = 0;
+        RangeAllocator vertices;        // 以顶点为单位
+        RangeAllocator indices;         // 以字节为单位
+        size_t rangeCount = 0;
+    };
+
+    std::vector<Pool> pools_;
+    std::vector<Range> ranges_;
+    std::vector<Handle> freeHandles_;
+    GLuint drawIdBuffer_ = 0;           // 0, 1, 2, ... MAX_DRAW_IDS - 1，所有池共用
+    uint64_t generation_ = 0;
+
+    GeometryArena() = default;
+    ~GeometryArena() = default;         // 静态对象析构时上下文已销毁，GL 对象由 destroy() 释放
+
+    uint32_t findPool(const VertexLayout& layout)
+    {
+        for (uint32_t p = 0; p < pools_.size(); p++)
+            if (pools_[p].layout.mask == layout.mask && pools_[p].layout.format == layout.format)
+                return p;
+
+        Pool pool;
+        pool.layout = layout;
+        pool.vertices.reset(VERTEX_POOL_BYTES / layout.stride);
+        pool.indices.reset(INDEX_POOL_BYTES);
+
+        GLStateCache& state = GLStateCache::instance();
+        glGenVertexArrays(1, &pool.VAO);
+        state.bindVertexArray(pool.VAO);
+        pool.VBO = createBuffer(GL_ARRAY_BUFFER, pool.vertices.capacity() * layout.stride);
+        glGenBuffers(1, &pool.EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, pool.indices.capacity(), NULL, GL_STATIC_DRAW);
+        layout.apply();
+        if (multiDrawSupported())
+            applyDrawId();
+        state.bindVertexArray(0);
+
+        pools_.push_back(pool);
+        return (uint32_t)(pools_.size() - 1);
+    }
+
+    // 当前 VAO 的 drawId 实例属性，每个实例前进一项，从 baseInstance 开始
+    void applyDrawId()
+    {
+        GLStateCache& state = GLStateCache::instance();
+        if (drawIdBuffer_ == 0) {
+            std::vector<GLuint> ids(MAX_DRAW_IDS);
+            for (GLuint i = 0; i < MAX_DRAW_IDS; i++)
+                ids[i] = i;
+            drawIdBuffer_ = createBuffer(GL_ARRAY_BUFFER, ids.size() * sizeof(GLuint));
+            glBufferSubData(GL_ARRAY_BUFFER, 0, ids.size() * sizeof(GLuint), ids.data());
+        }
+        state.bindBuffer(GL_ARRAY_BUFFER, drawIdBuffer_);
+        glVertexAttribIPointer(DRAW_ID_LOCATION, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+        glVertexAttribDivisor(DRAW_ID_LOCATION, 1);
+        glEnableVertexAttribArray(DRAW_ID_LOCATION);
+    }
+
+    static GLuint createBuffer(GLenum target, size_t bytes)
+    {
+        GLuint buffer = 0;
+        glGenBuffers(1, &buffer);
+        GLStateCache::instance().bindBuffer(target, buffer);
+        glBufferData(target, bytes, NULL, GL_STATIC_DRAW);
+        return buffer;
+    }
+
+    // 扩容：新缓冲拷贝旧内容后替换，已有记录的偏移不变
+    void growVertices(Pool& pool, size_t vertexCapacity)
+    {
+        size_t stride = pool.layout.stride;
+        GLuint vbo = createBuffer(GL_ARRAY_BUFFER, vertexCapacity * stride);
+        copyBuffer(pool.VBO, vbo, pool.vertices.capacity() * stride);
+        replaceVertexBuffer(pool, vbo);
+        pool.vertices.grow(vertexCapacity);
+    }
+
+    void growIndices(Pool& pool, size_t byteCapacity)
+    {
+        GLuint ebo = createBuffer(GL_ARRAY_BUFFER, byteCapacity);
+        copyBuffer(pool.EBO, ebo, pool.indices.capacity());
+        replaceIndexBuffer(pool, ebo);
+        pool.indices.grow(byteCapacity);
+    }
+
+    static void copyBuffer(GLuint source, GLuint destination, size_t bytes)
+    {
+        GLStateCache& state = GLStateCache::instance();
+        state.bindBuffer(GL_COPY_READ_BUFFER, source);
+        state.bindBuffer(GL_COPY_WRITE_BUFFER, destination);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, bytes);
+    }
+
+    // 属性指针记录的是设置时绑定的 VBO，更换缓冲后需要重新设置
+    static void replaceVertexBuffer(Pool& pool, GLuint vbo)
+    {
+        GLStateCache& state = GLStateCache::instance();
+        glDeleteBuffers(1, &pool.VBO);
+        state.bufferDeleted(pool.VBO);
+        pool.VBO = vbo;
+        state.bindVertexArray(pool.VAO);
+        state.bindBuffer(GL_ARRAY_BUFFER, vbo);
+        pool.layout.apply();
+        state.bindVertexArray(0);
+    }
+
+    static void replaceIndexBuffer(Pool& pool, GLuint ebo)
+    {
+        GLStateCache& state = GLStateCache::instance();
+        glDeleteBuffers(1, &pool.EBO);
+        state.bufferDeleted(pool.EBO);
+        pool.EBO = ebo;
+        state.bindVertexArray(pool.VAO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        state.bindVertexArray(0);
+    }
+};
+
+#endif
@@ -0,0 +1,223 @@
+#ifndef MULTI_DRAW_BATCH_H
+#define MULTI_DRAW_BATCH_H
+
+#include <glad/glad.h>
+
+#include "GLStateCache.h"
+#include "GeometryArena.h"
+#include "Struct/Mesh.h"
+
+#include <iostream>
+#include <vector>
+
+// 多重间接绘制批次：把位于 GeometryArena 中的网格按 (池 VAO, 索引宽度, 纹理组合) 分组，
+// 每组生成一段 DrawElementsIndirectCommand，用一次 glMultiDrawElementsIndirect 提交
+// 每条命令的 baseInstance 为网格在 meshes 中的下标，着色器中 location = GeometryArena::DRAW_ID_LOCATION 的 drawId
+// 即为该下标，可用它查找逐绘制的模型矩阵或材质（见 drawBatch.vs）
+// 不支持多重间接绘制（GL 3.3）时退化为 CPU 循环：每组只绑定一次 VAO 与纹理，逐条 glDrawElementsBaseVertex，
+// 并用 glVertexAttribI1ui 设置 drawId，着色器侧无需区分两条路径
+// 命令记录的是池中的区间，网格列表（句柄）改变或池发生分配、释放、整理后在下一次 render() 时自动重建
+class MultiDrawBatch
+{
+public:
+    // 与 GL 规范中的布局一致
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint  baseVertex;
+        GLuint baseInstance;
+    };
+
+    MultiDrawBatch() = default;
+    ~MultiDrawBatch() { destroy(); }
+
+    MultiDrawBatch(const MultiDrawBatch&) = delete;
+    MultiDrawBatch& operator=(const MultiDrawBatch&) = delete;
+
+    MultiDrawBatch(MultiDrawBatch&& other) noexcept
+        : commands_(std::move(other.commands_))
+        , groups_(std::move(other.groups_))
+        , handles_(std::move(other.handles_))
+        , indirectBuffer_(other.indirectBuffer_)
+        , generation_(other.generation_)
+        , built_(other.built_)
+    {
+        other.indirectBuffer_ = 0;
+        other.built_ = false;
+    }
+
+    MultiDrawBatch& operator=(MultiDrawBatch&& other) noexcept
+    {
+        if (this != &other) {
+            destroy();
+            commands_ = std::move(other.commands_);
+            groups_ = std::move(other.groups_);
+            indirectBuffer_ = other.indirectBuffer_;
+            handles_ = std::move(other.handles_);
+            generation_ = other.generation_;
+            built_ = other.built_;
+            other.indirectBuffer_ = 0;
+            other.built_ = false;
+        }
+        return *this;
+    }
+
+    // 生成分组与命令；存在不在 GeometryArena 中的网格或网格数超过 MAX_DRAW_IDS 时返回 false
+    bool build(const std::vector<Mesh>& meshes)
+    {
+        GeometryArena& arena = GeometryArena::instance();
+        generation_ = arena.generation();
+        built_ = false;
+        commands_.clear();
+        groups_.clear();
+        handles_.clear();
+        if (meshes.size() > GeometryArena::MAX_DRAW_IDS)
+            return false;
+
+        // 分组：同一池（VAO）、同一索引宽度、同一组纹理
+        std::vector<std::vector<size_t>> members;
+        for (size_t m = 0; m < meshes.size(); m++) {
+            const Mesh& mesh = meshes[m];
+            if (!arena.valid(mesh.arenaHandle))
+                return false;
+            handles_.push_back(mesh.arenaHandle);
+            const GeometryArena::Range& range = arena.range(mesh.arenaHandle);
+            GLuint vertexArray = arena.vertexArray(mesh.arenaHandle);
+
+            size_t g = 0;
+            for (; g < groups_.size(); g++) {
+                if (groups_[g].vertexArray == vertexArray && groups_[g].indexType == range.indexType
+                    && sameTextures(meshes[groups_[g].material].textures, mesh.textures))
+                    break;
+            }
+            if (g == groups_.size()) {
+                Group group;
+                group.vertexArray = vertexArray;
+                group.indexType = range.indexType;
+                group.material = m;
+                groups_.push_back(group);
+                members.emplace_back();
+            }
+            members[g].push_back(m);
+        }
+
+        for (size_t g = 0; g < groups_.size(); g++) {
+            groups_[g].first = commands_.size();
+            groups_[g].count = (GLsizei)members[g].size();
+            for (size_t m : members[g]) {
+                const GeometryArena::Range& range = arena.range(meshes[m].arenaHandle);
+                DrawElementsIndirectCommand command;
+                command.count = (GLuint)meshes[m].indexCount();
+                command.instanceCount = 1;
+                command.firstIndex = range.firstIndex();
+                command.baseVertex = range.baseVertex;
+                command.baseInstance = (GLuint)m;
+                commands_.push_back(command);
+            }
+        }
+
+        if (GeometryArena::multiDrawSupported() && !commands_.empty()) {
+#ifdef GL_DRAW_INDIRECT_BUFFER
+            GLStateCache& state = GLStateCache::instance();
+            if (indirectBuffer_ == 0)
+                glGenBuffers(1, &indirectBuffer_);
+            state.bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer_);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, commands_.size() * sizeof(DrawElementsIndirectCommand), commands_.data(), GL_STATIC_DRAW);
+#endif
+        }
+        built_ = true;
+        return true;
+    }
+
+    // 绘制 meshes；网格不全在 GeometryArena 中时返回 false，由调用方逐个绘制
+    bool render(const Shader& shader, const std::vector<Mesh>& meshes)
+    {
+        if (!built_ || !sameHandles(meshes) || GeometryArena::instance().generation() != generation_) {
+            if (!build(meshes))
+                return false;
+        }
+
+        GLStateCache& state = GLStateCache::instance();
+        shader.use();
+        bool multiDraw = indirectBuffer_ != 0;
+#ifdef GL_DRAW_INDIRECT_BUFFER
+        if (multiDraw)
+            state.bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer_);
+#endif
+        for (const Group& group : groups_) {
+            meshes[group.material].bindTextures(shader);
+            state.bindVertexArray(group.vertexArray);
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_multi_draw_indirect)
+            if (multiDraw) {
+                glMultiDrawElementsIndirect(GL_TRIANGLES, group.indexType,
+                                            (void*)(group.first * sizeof(DrawElementsIndirectCommand)), group.count, 0);
+                continue;
+            }
+#endif
+            size_t indexSize = IndexFormat::typeSize(group.indexType);
+            for (GLsizei i = 0; i < group.count; i++) {
+                const DrawElementsIndirectCommand& command = commands_[group.first + i];
+                glVertexAttribI1ui(GeometryArena::DRAW_ID_LOCATION, command.baseInstance);
+                glDrawElementsBaseVertex(GL_TRIANGLES, command.count, group.indexType,
+                                         (void*)(command.firstIndex * indexSize), command.baseVertex);
+            }
+        }
+        return true;
+    }
+
+    void destroy()
+    {
+        if (indirectBuffer_) {
+            glDeleteBuffers(1, &indirectBuffer_);
+            GLStateCache::instance().bufferDeleted(indirectBuffer_);
+            indirectBuffer_ = 0;
+        }
+        commands_.clear();
+        groups_.clear();
+        handles_.clear();
+        built_ = false;
+    }
+
+    size_t drawCount() const { return commands_.size(); }
+    size_t groupCount() const { return groups_.size(); }
+    bool multiDraw() const { return indirectBuffer_ != 0; }
+
+private:
+    struct Group {
+        GLuint vertexArray = 0;
+        GLenum indexType = GL_UNSIGNED_INT;
+        size_t material = 0;            // 提供纹理的网格下标
+        size_t first = 0;               // 第一条命令的下标
+        GLsizei count = 0;
+    };
+
+    std::vector<DrawElementsIndirectCommand> commands_;
+    std::vector<Group> groups_;
+    std::vector<GeometryArena::Handle> handles_;    // build() 时各网格的池句柄，用于判断网格列表是否改变
+    GLuint indirectBuffer_ = 0;
+    uint64_t generation_ = 0;
+    bool built_ = false;
+
+    bool sameHandles(const std::vector<Mesh>& meshes) const
+    {
+        if (meshes.size() != handles_.size())
+            return false;
+        for (size_t m = 0; m < meshes.size(); m++)
+            if (meshes[m].arenaHandle != handles_[m])
+                return false;
+        return true;
+    }
+
+    static bool sameTextures(const std::vector<Texture>& a, const std::vector<Texture>& b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); i++)
+            if (a[i].id != b[i].id || a[i].type != b[i].type)
+                return false;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,206 @@
+#ifndef STREAMING_VERTEX_BUFFER_H
+#define STREAMING_VERTEX_BUFFER_H
+
+#include <glad/glad.h>
+
+#include "GLStateCache.h"
+
+#include <cstring>
+#include <iostream>
+
+// 频繁更新的顶点缓冲（动态几何体使用），缓冲对象在整个生命周期内不变，VAO 的属性指针无需重新设置
+// 持久映射模式（GL 4.4 / ARB_buffer_storage）：不可变存储分成 REGION_COUNT 段，每次更新写下一段
+//     更新时在切换前放置 glFenceSync（覆盖之前所有使用上一段的绘制），写入某段之前等待其栅栏
+//     绘制时以 baseVertex() 作为 glDrawElementsBaseVertex 的顶点偏移，索引缓冲不变
+// 回退模式（GL 3.3）：只有一段，每次更新 glBufferData(NULL) 孤立旧存储后 glBufferSubData，驱动为新数据分配新存储，
+//     不等待 GPU 读完旧数据
+// 新数据超过容量时返回 false，由调用方重新 init()
+class StreamingVertexBuffer
+{
+public:
+    static const unsigned int REGION_COUNT = 3;
+
+    StreamingVertexBuffer() = default;
+    ~StreamingVertexBuffer() { destroy(); }
+
+    StreamingVertexBuffer(const StreamingVertexBuffer&) = delete;
+    StreamingVertexBuffer& operator=(const StreamingVertexBuffer&) = delete;
+
+    StreamingVertexBuffer(StreamingVertexBuffer&& other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    StreamingVertexBuffer& operator=(StreamingVertexBuffer&& other) noexcept
+    {
+        if (this != &other) {
+            destroy();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    // 以 bytes 为每段容量创建缓冲，并写入初始数据；stride 为顶点大小，段偏移按它换算为顶点偏移
+    // 调用后 GL_ARRAY_BUFFER 绑定为本缓冲，可直接设置顶点属性指针
+    bool init(GLsizeiptr bytes, const void* data, GLsizei stride, bool persistentMapping = true)
+    {
+        destroy();
+        if (bytes <= 0 || stride <= 0)
+            return false;
+        capacity_ = bytes;
+        stride_ = stride;
+
+        GLStateCache& state = GLStateCache::instance();
+        glGenBuffers(1, &buffer_);
+        state.bindBuffer(GL_ARRAY_BUFFER, buffer_);
+
+        bool immutable = false;
+#if defined(GL_VERSION_4_4) || defined(GL_ARB_buffer_storage)
+        bool bufferStorage = false;
+#if defined(GL_VERSION_4_4)
+        bufferStorage = bufferStorage || GLAD_GL_VERSION_4_4;
+#endif
+#if defined(GL_ARB_buffer_storage)
+        bufferStorage = bufferStorage || GLAD_GL_ARB_buffer_storage;
+#endif
+        if (persistentMapping && bufferStorage) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_ARRAY_BUFFER, capacity_ * REGION_COUNT, NULL, flags);
+            immutable = true;
+            mapped_ = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, capacity_ * REGION_COUNT, flags));
+            if (mapped_ == nullptr)
+                std::cout << "ERROR::STREAMING_VERTEX_BUFFER::MAP_FAILED, fallback to orphaning" << std::endl;
+        }
+#endif
+
+        if (mapped_ == nullptr) {
+            // 不可变存储无法重新分配，映射失败时换一个新缓冲
+            if (immutable) {
+                state.bufferDeleted(buffer_);
+                glDeleteBuffers(1, &buffer_);
+                glGenBuffers(1, &buffer_);
+                state.bindBuffer(GL_ARRAY_BUFFER, buffer_);
+            }
+            glBufferData(GL_ARRAY_BUFFER, capacity_, data, GL_DYNAMIC_DRAW);
+        }
+        else if (data != nullptr) {
+            std::memcpy(mapped_, data, (size_t)capacity_);
+        }
+
+        region_ = 0;
+        updates_ = 0;
+        stalls_ = 0;
+        return true;
+    }
+
+    // 写入新的顶点数据，bytes 超过每段容量时返回 false
+    bool update(const void* data, GLsizeiptr bytes)
+    {
+        if (buffer_ == 0 || bytes > capacity_)
+            return false;
+        updates_++;
+
+        if (persistent()) {
+            // 之前提交的绘制都在读当前段，栅栏放在切换之前
+            if (fences_[region_] != 0)
+                glDeleteSync(fences_[region_]);
+            fences_[region_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            region_ = (region_ + 1) % REGION_COUNT;
+            waitFence(fences_[region_]);
+            std::memcpy(mapped_ + regionOffset(), data, (size_t)bytes);
+            return true;
+        }
+
+        GLStateCache::instance().bindBuffer(GL_ARRAY_BUFFER, buffer_);
+        glBufferData(GL_ARRAY_BUFFER, capacity_, NULL, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data);
+        return true;
+    }
+
+    void destroy()
+    {
+        if (buffer_ == 0)
+            return;
+        for (unsigned int i = 0; i < REGION_COUNT; i++) {
+            if (fences_[i] != 0) {
+                glDeleteSync(fences_[i]);
+                fences_[i] = 0;
+            }
+        }
+        if (mapped_ != nullptr) {
+            GLStateCache::instance().bindBuffer(GL_ARRAY_BUFFER, buffer_);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            mapped_ = nullptr;
+        }
+        GLStateCache::instance().bufferDeleted(buffer_);
+        glDeleteBuffers(1, &buffer_);
+        buffer_ = 0;
+        capacity_ = 0;
+    }
+
+    bool valid() const { return buffer_ != 0; }
+    bool persistent() const { return mapped_ != nullptr; }
+    GLuint buffer() const { return buffer_; }
+    GLsizeiptr capacity() const { return capacity_; }
+
+    // 当前段的起始位置（字节 / 顶点），绘制时作为 baseVertex
+    GLintptr regionOffset() const { return (GLintptr)region_ * capacity_; }
+    GLint baseVertex() const { return stride_ > 0 ? (GLint)(regionOffset() / stride_) : 0; }
+
+    // 更新次数与 CPU 因等待栅栏而阻塞的次数，阻塞持续增长说明 REGION_COUNT 不够
+    unsigned int updates() const { return updates_; }
+    unsigned int stalls() const { return stalls_; }
+
+    void printStats() const
+    {
+        std::cout << "STREAMING_VERTEX_BUFFER:: " << (persistent() ? "persistent mapped" : "orphaning")
+                  << ", " << capacity_ << " bytes x " << (persistent() ? REGION_COUNT : 1)
+                  << ", updates: " << updates_
+                  << ", stalls: " << stalls_ << std::endl;
+    }
+
+private:
+    GLuint buffer_ = 0;
+    unsigned char* mapped_ = nullptr;
+    GLsync fences_[REGION_COUNT] = {};
+    GLsizeiptr capacity_ = 0;
+    GLsizei stride_ = 0;
+    unsigned int region_ = 0;
+    unsigned int updates_ = 0;
+    unsigned int stalls_ = 0;
+
+    void moveFrom(StreamingVertexBuffer& other)
+    {
+        buffer_ = other.buffer_;
+        mapped_ = other.mapped_;
+        for (unsigned int i = 0; i < REGION_COUNT; i++) {
+            fences_[i] = other.fences_[i];
+            other.fences_[i] = 0;
+        }
+        capacity_ = other.capacity_;
+        stride_ = other.stride_;
+        region_ = other.region_;
+        updates_ = other.updates_;
+        stalls_ = other.stalls_;
+        other.buffer_ = 0;
+        other.mapped_ = nullptr;
+        other.capacity_ = 0;
+    }
+
+    void waitFence(GLsync& fence)
+    {
+        if (fence == 0)
+            return;
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED) {
+            stalls_++;
+            do {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        fence = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef UNIFORM_RING_H
+#define UNIFORM_RING_H
+
+#include <glad/glad.h>
+
+#include "GLStateCache.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// 每帧 uniform 数据的环形缓冲
+// 持久映射模式（GL 4.4 / ARB_buffer_storage）：一块不可变存储分成 FRAME_COUNT 段，每帧写一段
+//     CPU 直接写入映射内存，每帧结束放置 glFenceSync，重新使用某段之前等待其栅栏，避免覆盖 GPU 仍在读取的数据
+// 回退模式（GL 3.3）：数据先写入 CPU 暂存区，每帧第一次 flush() 时 glBufferData(NULL) 孤立旧存储，再用 glBufferSubData 上传
+// 子分配按 GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 对齐，绘制前用 glBindBufferRange 绑定对应区间
+//
+// 每帧的使用顺序：
+//     beginFrame() -> push()/allocate() 写入数据 -> flush() -> bind() 并绘制 -> ... -> endFrame()
+// 一帧内可以多次 push/flush，但应尽量先写入本帧全部数据再 flush 一次
+class UniformRing
+{
+public:
+    static const unsigned int FRAME_COUNT = 3;
+
+    // 一次子分配：data 在 flush() 之前可写
+    struct Allocation {
+        GLintptr offset = 0;
+        GLsizeiptr size = 0;
+        void* data = nullptr;
+
+        bool valid() const { return data != nullptr; }
+    };
+
+    UniformRing() = default;
+    ~UniformRing() { destroy(); }
+
+    UniformRing(const UniformRing&) = delete;
+    UniformRing& operator=(const UniformRing&) = delete;
+
+    // bytesPerFrame 为一帧内所有分配的总容量上限
+    bool init(GLsizeiptr bytesPerFrame)
+    {
+        destroy();
+
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        alignment_ = alignment > 0 ? alignment : 256;
+        frameCapacity_ = alignUp(bytesPerFrame);
+
+        glGenBuffers(1, &buffer_);
+        GLStateCache::instance().bindBuffer(GL_UNIFORM_BUFFER, buffer_);
+
+        bool immutable = false;
+#if defined(GL_VERSION_4_4) || defined(GL_ARB_buffer_storage)
+        bool bufferStorage = false;
+#if defined(GL_VERSION_4_4)
+        bufferStorage = bufferStorage || GLAD_GL_VERSION_4_4;
+#endif
+#if defined(GL_ARB_buffer_storage)
+        bufferStorage = bufferStorage || GLAD_GL_ARB_buffer_storage;
+#endif
+        if (bufferStorage) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_UNIFORM_BUFFER, frameCapacity_ * FRAME_COUNT, NULL, flags);
+            immutable = true;
+            mapped_ = static_cast<unsigned char*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, frameCapacity_ * FRAME_COUNT, flags));
+            if (mapped_ == nullptr)
+                std::cout << "ERROR::UNIFORM_RING::MAP_FAILED, fallback to orphaning" << std::endl;
+        }
+#endif
+
+        if (mapped_ == nullptr) {
+            // 不可变存储无法重新分配，映射失败时换一个新缓冲
+            if (immutable) {
+                GLStateCache::instance().bufferDeleted(buffer_);
+                glDeleteBuffers(1, &buffer_);
+                glGenBuffers(1, &buffer_);
+                GLStateCache::instance().bindBuffer(GL_UNIFORM_BUFFER, buffer_);
+            }
+            glBufferData(GL_UNIFORM_BUFFER, frameCapacity_, NULL, GL_STREAM_DRAW);
+            staging_.assign((size_t)frameCapacity_, 0);
+        }
+
+        frame_ = 0;
+        used_ = 0;
+        flushed_ = 0;
+        return true;
+    }
+
+    void destroy()
+    {
+        if (buffer_ == 0)
+            return;
+        for (unsigned int i = 0; i < FRAME_COUNT; i++) {
+            if (fences_[i] != 0) {
+                glDeleteSync(fences_[i]);
+                fences_[i] = 0;
+            }
+        }
+        if (mapped_ != nullptr) {
+            GLStateCache::instance().bindBuffer(GL_UNIFORM_BUFFER, buffer_);
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+            mapped_ = nullptr;
+        }
+        GLStateCache::instance().bufferDeleted(buffer_);
+        glDeleteBuffers(1, &buffer_);
+        buffer_ = 0;
+        staging_.clear();
+    }
+
+    bool persistent() const { return mapped_ != nullptr; }
+    GLuint buffer() const { return buffer_; }
+    GLint alignment() const { return alignment_; }
+
+    // 切换到下一段；持久映射模式下等待该段上一次使用的栅栏
+    void beginFrame()
+    {
+        frame_ = (frame_ + 1) % FRAME_COUNT;
+        used_ = 0;
+        flushed_ = 0;
+        if (persistent())
+            waitFence(fences_[frame_]);
+    }
+
+    // 本帧所有使用环形缓冲的绘制提交之后调用
+    void endFrame()
+    {
+        if (!persistent())
+            return;
+        if (fences_[frame_] != 0)
+            glDeleteSync(fences_[frame_]);
+        fences_[frame_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    // 分配 size 字节，起始偏移满足 uniform 缓冲对齐要求；容量不足时返回无效分配
+    Allocation allocate(GLsizeiptr size)
+    {
+        Allocation allocation;
+        GLsizeiptr alignedSize = alignUp(size);
+        if (used_ + alignedSize > frameCapacity_) {
+            if (!overflowReported_) {
+                std::cout << "ERROR::UNIFORM_RING::OUT_OF_SPACE: " << frameCapacity_ << " bytes per frame" << std::endl;
+                overflowReported_ = true;
+            }
+            return allocation;
+        }
+
+        allocation.size = size;
+        if (persistent()) {
+            allocation.offset = frameBase() + used_;
+            allocation.data = mapped_ + allocation.offset;
+        }
+        else {
+            allocation.offset = used_;
+            allocation.data = staging_.data() + used_;
+        }
+        used_ += alignedSize;
+        return allocation;
+    }
+
+    // 分配并写入一个 std140 布局的结构体
+    template <typename T>
+    Allocation push(const T& value)
+    {
+        Allocation allocation = allocate(sizeof(T));
+        if (allocation.valid())
+            std::memcpy(allocation.data, &value, sizeof(T));
+        return allocation;
+    }
+
+    // 使上次 flush 之后写入的数据对 GPU 可见
+    // 持久映射为一致性映射，无需操作；回退模式只上传新增区间，本帧第一次上传前先孤立旧存储
+    void flush()
+    {
+        if (persistent() || used_ == flushed_)
+            return;
+        GLStateCache::instance().bindBuffer(GL_UNIFORM_BUFFER, buffer_);
+        if (flushed_ == 0)
+            glBufferData(GL_UNIFORM_BUFFER, frameCapacity_, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_UNIFORM_BUFFER, flushed_, used_ - flushed_, staging_.data() + flushed_);
+        flushed_ = used_;
+    }
+
+    // 将分配的区间绑定到 uniform 块绑定点，尚未 flush 的数据会先上传
+    void bind(GLuint binding, const Allocation& allocation)
+    {
+        if (!allocation.valid())
+            return;
+        flush();
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer_, allocation.offset, allocation.size);
+        GLStateCache::instance().bufferBoundIndexed(GL_UNIFORM_BUFFER, buffer_);
+    }
+
+    // CPU 因等待栅栏而阻塞的次数，持续增长说明 FRAME_COUNT 不够
+    unsigned int stalls() const { return stalls_; }
+
+    void printStats() const
+    {
+        std::cout << "UNIFORM_RING:: " << (persistent() ? "persistent mapped" : "orphaning")
+                  << ", " << used_ << "/" << frameCapacity_ << " bytes used this frame"
+                  << ", alignment: " << alignment_
+                  << ", stalls: " << stalls_ << std::endl;
+    }
+
+private:
+    GLuint buffer_ = 0;
+    unsigned char* mapped_ = nullptr;
+    std::vector<unsigned char> staging_;
+    GLsync fences_[FRAME_COUNT] = {};
+
+    GLint alignment_ = 256;
+    GLsizeiptr frameCapacity_ = 0;
+    GLsizeiptr used_ = 0;
+    GLsizeiptr flushed_ = 0;
+    unsigned int frame_ = 0;
+    unsigned int stalls_ = 0;
+    bool overflowReported_ = false;
+
+    GLsizeiptr alignUp(GLsizeiptr size) const
+    {
+        return (size + alignment_ - 1) / alignment_ * alignment_;
+    }
+
+    GLintptr frameBase() const
+    {
+        return (GLintptr)frame_ * frameCapacity_;
+    }
+
+    void waitFence(GLsync& fence)
+    {
+        if (fence == 0)
+            return;
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED) {
+            stalls_++;
+            do {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        fence = 0;
+    }
+};
+
+#endif
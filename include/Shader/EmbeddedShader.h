@@ -0,0 +1,13 @@
+#ifndef EMBEDDED_SHADER_H
+#define EMBEDDED_SHADER_H
+
+#include <string_view>
+
+// 构建时内嵌进可执行文件的着色器源码，由 cmake/EmbedShaders.cmake 生成到 Shader/EmbeddedShaders.h
+// name 为源文件名（如 "Shader.fs"），同时用作程序二进制缓存的标签
+struct EmbeddedShader {
+    std::string_view name;
+    std::string_view source;
+};
+
+#endif
@@ -0,0 +1,237 @@
+#ifndef PROGRAM_BINARY_CACHE_H
+#define PROGRAM_BINARY_CACHE_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 着色器程序二进制缓存：把 glGetProgramBinary 的结果存到缓存目录，下次启动时用 glProgramBinary 直接加载
+// 缓存键 = 顶点/片段/几何着色器源码 + 驱动的 vendor/renderer/version，任意一项改变都会使缓存失效
+// 默认关闭，调用 setDirectory() 设置缓存目录后启用
+class ProgramBinaryCache
+{
+public:
+    static ProgramBinaryCache& instance()
+    {
+        static ProgramBinaryCache cache;
+        return cache;
+    }
+
+    // 设置缓存目录并启用缓存；传入空字符串则关闭
+    void setDirectory(const std::string& directory)
+    {
+        directory_ = directory;
+        if (!directory_.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(directory_, ec);
+        }
+    }
+
+    // 当前驱动是否支持程序二进制，且缓存已启用
+    bool enabled() const
+    {
+        return !directory_.empty() && supported();
+    }
+
+    // 根据源码与驱动信息计算缓存键
+    uint64_t makeKey(const std::string& vertexCode, const std::string& fragmentCode, const std::string& geometryCode) const
+    {
+        uint64_t hash = 14695981039346656037ull;
+        hash = hashBytes(hash, vertexCode.data(), vertexCode.size());
+        hash = hashBytes(hash, "\0", 1);
+        hash = hashBytes(hash, fragmentCode.data(), fragmentCode.size());
+        hash = hashBytes(hash, "\0", 1);
+        hash = hashBytes(hash, geometryCode.data(), geometryCode.size());
+        const GLenum driverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+        for (GLenum name : driverStrings) {
+            const char* value = reinterpret_cast<const char*>(glGetString(name));
+            if (value != nullptr) {
+                hash = hashBytes(hash, "\0", 1);
+                hash = hashBytes(hash, value, std::char_traits<char>::length(value));
+            }
+        }
+        return hash;
+    }
+
+    // 尝试从缓存加载程序二进制，成功返回 true 且 program 已链接可用
+    // 键不一致或驱动拒绝该二进制时删除缓存文件并返回 false；文件属于另一个名称相撞的程序时只返回 false
+    bool load(GLuint program, const std::string& label, uint64_t key)
+    {
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        std::string path = filePath(label);
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        Header header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || header.magic != MAGIC || header.version != VERSION || header.key != key) {
+            file.close();
+            invalidate(label);
+            return false;
+        }
+
+        std::string storedLabel(header.labelLength, '\0');
+        file.read(&storedLabel[0], header.labelLength);
+        if (!file || storedLabel != label)
+            return false;
+
+        std::vector<char> binary(header.length);
+        file.read(binary.data(), header.length);
+        if (!file) {
+            file.close();
+            invalidate(label);
+            return false;
+        }
+        file.close();
+
+        glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            invalidate(label);
+            return false;
+        }
+        return true;
+#else
+        (void)program; (void)label; (void)key;
+        return false;
+#endif
+    }
+
+    // 把已链接程序的二进制写入缓存
+    void store(GLuint program, const std::string& label, uint64_t key)
+    {
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+        Header header;
+        header.key = key;
+        header.format = format;
+        header.length = (uint32_t)length;
+        header.labelLength = (uint32_t)label.size();
+
+        std::ofstream file(filePath(label), std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cout << "ERROR::SHADER_CACHE::FILE_NOT_WRITABLE: " << filePath(label) << std::endl;
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(label.data(), (std::streamsize)label.size());
+        file.write(binary.data(), length);
+#else
+        (void)program; (void)label; (void)key;
+#endif
+    }
+
+    // 链接前调用，提示驱动保留可读取的二进制
+    void prepareForLink(GLuint program) const
+    {
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        if (enabled())
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#else
+        (void)program;
+#endif
+    }
+
+    // 记录并输出单个程序的加载情况
+    void report(const std::string& label, bool hit, double milliseconds)
+    {
+        if (hit)
+            hits_++;
+        else
+            misses_++;
+        std::cout << "SHADER_CACHE::" << (hit ? "HIT " : "MISS") << " " << label << " " << milliseconds << " ms" << std::endl;
+    }
+
+    void printStats() const
+    {
+        std::cout << "SHADER_CACHE:: hits: " << hits_ << ", misses: " << misses_ << std::endl;
+    }
+
+private:
+    // 文件布局：Header，完整的程序名称（labelLength 字节），程序二进制（length 字节）
+    struct Header {
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint64_t key = 0;
+        uint32_t format = 0;
+        uint32_t length = 0;
+        uint32_t labelLength = 0;
+        uint32_t reserved = 0;
+    };
+
+    static constexpr uint32_t MAGIC = 0x42504C47;   // "GLPB"
+    static constexpr uint32_t VERSION = 1;
+
+    std::string directory_;
+    int hits_ = 0;
+    int misses_ = 0;
+
+    ProgramBinaryCache() = default;
+
+    static bool supported()
+    {
+        static int cached = -1;
+        if (cached < 0) {
+            cached = 0;
+            bool extension = false;
+#if defined(GL_VERSION_4_1)
+            extension = extension || GLAD_GL_VERSION_4_1;
+#endif
+#if defined(GL_ARB_get_program_binary)
+            extension = extension || GLAD_GL_ARB_get_program_binary;
+#endif
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+            if (extension) {
+                // 部分驱动声明支持但不提供任何二进制格式
+                GLint formats = 0;
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+                cached = formats > 0 ? 1 : 0;
+            }
+#endif
+            (void)extension;
+        }
+        return cached == 1;
+    }
+
+    static uint64_t hashBytes(uint64_t hash, const char* data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++) {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // 每个程序一个缓存文件，文件名为完整名称的 64 位哈希；名称本身与键存放在文件中，加载时逐一核对
+    std::string filePath(const std::string& label) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin",
+                      (unsigned long long)hashBytes(14695981039346656037ull, label.data(), label.size()));
+        return (std::filesystem::path(directory_) / name).string();
+    }
+
+    void invalidate(const std::string& label) const
+    {
+        std::error_code ec;
+        std::filesystem::remove(filePath(label), ec);
+    }
+};
+
+#endif
@@ -4,51 +4,43 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "UniformCache.h"
+#include "ShaderReflection.h"
+#include "ProgramBinaryCache.h"
+#include "ShaderSource.h"
+#include "Render/GLStateCache.h"
+
 #include <string>
+#include <map>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <chrono>
+#include <type_traits>
+
+// 预处理宏集合：名称 -> 值（值可为空），std::map 保证遍历顺序稳定
+using ShaderDefines = std::map<std::string, std::string>;
 
 class Shader
 {
 public:
     unsigned int ID;
     // 构造函数，运行时生成着色器
+    // 源码按 ShaderSource 的顺序查找：覆盖目录 -> 内嵌源码 -> 磁盘文件，因此这里传文件名即可
+    // defines 中的宏会被注入到每个阶段源码的 #version 之后
     // ------------------------------------------------------------------------
-    Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr)
+    Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr, const ShaderDefines& defines = ShaderDefines())
     {
-        // 1. 从文件路径读取顶点/片段着色器源码
+        // 1. 获取顶点/片段着色器源码
         std::string vertexCode;
         std::string fragmentCode;
         std::string geometryCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-        std::ifstream gShaderFile;
-        // 确保ifstream对象可以抛出异常：
-        vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        gShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
         try 
         {
-            // 打开文件
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
-            // 读取文件缓冲内容到数据流
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();
-            // 关闭文件处理器
-            vShaderFile.close();
-            fShaderFile.close();
-            // 将数据流转换为字符串
-            vertexCode   = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
+            vertexCode   = ShaderSource::load(vertexPath);
+            fragmentCode = ShaderSource::load(fragmentPath);
             if (geometryPath != nullptr) {
-                gShaderFile.open(geometryPath);
-                std::stringstream gShaderStream;
-                gShaderStream << gShaderFile.rdbuf();
-                gShaderFile.close();
-                geometryCode = gShaderStream.str();
+                geometryCode = ShaderSource::load(geometryPath);
             }
         }
         catch (std::ifstream::failure& e)
@@ -56,128 +48,294 @@ public:
             std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
             std::cout << "QUESTION HAPPEN WITH FILE:" << vertexPath << "\t" << fragmentPath << std::endl;
         }
-        const char* vShaderCode = vertexCode.c_str();
-        const char* fShaderCode = fragmentCode.c_str();
-        const char* gShaderCode = nullptr;
+
+        std::string label = std::string(vertexPath) + "|" + fragmentPath;
         if (geometryPath != nullptr) {
-            gShaderCode = geometryCode.c_str();
+            label += std::string("|") + geometryPath;
         }
-        
-        // 2. 编译着色器
-        unsigned int vertex, fragment, geometry;
-        // 顶点着色器
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vShaderCode, NULL);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
-        // -------------------------
-
-        // 片段着色器
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fShaderCode, NULL);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
-        // -------------------------
+        create(vertexCode, fragmentCode, geometryCode, label, defines);
+    }
 
-        // 几何着色器
-        if (gShaderCode != nullptr) {
-            geometry = glCreateShader(GL_GEOMETRY_SHADER);
-            glShaderSource(geometry, 1, &gShaderCode, NULL);
-            glCompileShader(geometry);
-            checkCompileErrors(geometry, "GEOMETRY");
+    // 直接使用构建时内嵌的源码，例如 Shader(EmbeddedShaders::Shader_vs, EmbeddedShaders::Shader_fs)
+    // ------------------------------------------------------------------------
+    Shader(const EmbeddedShader& vertex, const EmbeddedShader& fragment, const EmbeddedShader* geometry = nullptr, const ShaderDefines& defines = ShaderDefines())
+    {
+        std::string label = std::string(vertex.name) + "|" + std::string(fragment.name);
+        std::string geometryCode;
+        if (geometry != nullptr) {
+            label += "|" + std::string(geometry->name);
+            geometryCode = ShaderSource::load(*geometry);
         }
+        create(ShaderSource::load(vertex), ShaderSource::load(fragment), geometryCode, label, defines);
+    }
 
-        // 着色器程序
-        ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
+    // 接管一个已经链接好的程序（供 ShaderLoader 异步创建后使用）
+    // ------------------------------------------------------------------------
+    explicit Shader(unsigned int program) : ID(program)
+    {
+        reflection_.build(ID);
+    }
 
-        if (geometryPath != nullptr) {
-            glAttachShader(ID, geometry);
+    // 在 #version 行之后插入 #define；跳过被注释掉的 #version，没有 #version 时插在开头
+    // ------------------------------------------------------------------------
+    static std::string injectDefines(const std::string& source, const ShaderDefines& defines)
+    {
+        std::string block;
+        for (const auto& define : defines) {
+            block += "#define " + define.first;
+            if (!define.second.empty())
+                block += " " + define.second;
+            block += "\n";
         }
-    
-        glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
-        // -------------------------
 
-        // 删除着色器，它们已经链接到程序中了，不再需要
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-
-        if (geometryPath != nullptr) {
-            glDeleteShader(geometry);
+        size_t lineStart = 0;
+        while (lineStart < source.size()) {
+            size_t lineEnd = source.find('\n', lineStart);
+            size_t contentStart = source.find_first_not_of(" \t", lineStart);
+            if (contentStart != std::string::npos && source.compare(contentStart, 8, "#version") == 0) {
+                if (lineEnd == std::string::npos)
+                    return source + "\n" + block;
+                return source.substr(0, lineEnd + 1) + block + source.substr(lineEnd + 1);
+            }
+            if (lineEnd == std::string::npos)
+                break;
+            lineStart = lineEnd + 1;
         }
+        return block + source;
     }
-    // 激活着色器
+    // 激活着色器（已是当前程序时跳过 glUseProgram）
     // ------------------------------------------------------------------------
-    void use() 
+    void use() const
     { 
-        glUseProgram(ID); 
+        GLStateCache::instance().useProgram(ID); 
+    }
+
+    // 从缓存中查询 uniform location，不再调用 glGetUniformLocation
+    // ------------------------------------------------------------------------
+    GLint getUniformLocation(const UniformKey &key) const
+    {
+        return reflection_.cache().find(key);
+    }
+
+    // 链接期反射表
+    // ------------------------------------------------------------------------
+    const ShaderReflection& reflection() const
+    {
+        return reflection_;
+    }
+
+    // 解析带类型的 uniform 句柄，类型与着色器声明不一致时返回无效句柄
+    // int 句柄也可用于采样器
+    // ------------------------------------------------------------------------
+    template <typename T>
+    UniformHandle<T> uniform(const UniformKey &name) const
+    {
+        UniformHandle<T> handle;
+        const UniformEntry* entry = reflection_.cache().lookup(name);
+        if (entry == nullptr)
+            return handle;
+        bool samplerAsInt = std::is_same<T, int>::value && ShaderReflection::isSampler(entry->type);
+        if (entry->type != UniformType<T>::value && !samplerAsInt) {
+            std::cout << "ERROR::SHADER::UNIFORM_TYPE_MISMATCH: " << name.name << std::endl;
+            return handle;
+        }
+        handle.location = entry->location;
+        return handle;
+    }
+
+    template <typename T>
+    void set(const UniformHandle<T> &handle, const typename UniformHandle<T>::value_type &value) const
+    {
+        uploadUniform(handle.location, value);
+    }
+
+    // 采样器在链接时自动分配的纹理单元，不是采样器或不存在时返回 -1
+    // ------------------------------------------------------------------------
+    GLint samplerUnit(const UniformKey &name) const
+    {
+        const UniformEntry* entry = reflection_.cache().lookup(name);
+        return entry ? entry->textureUnit : -1;
     }
     
     // uniform工具函数
     // ------------------------------------------------------------------------
-    void setBool(const std::string &name, bool value) const
+    void setBool(const UniformKey &name, bool value) const
     {         
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+        glUniform1i(reflection_.cache().find(name), (int)value); 
     }
     // ------------------------------------------------------------------------
-    void setInt(const std::string &name, int value) const
+    void setInt(const UniformKey &name, int value) const
     { 
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+        glUniform1i(reflection_.cache().find(name), value); 
     }
     // ------------------------------------------------------------------------
-    void setFloat(const std::string &name, float value) const
+    void setFloat(const UniformKey &name, float value) const
     { 
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+        glUniform1f(reflection_.cache().find(name), value); 
     }
         // ------------------------------------------------------------------------
-    void setVec2(const std::string &name, const glm::vec2 &value) const
+    void setVec2(const UniformKey &name, const glm::vec2 &value) const
     { 
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform2fv(reflection_.cache().find(name), 1, &value[0]); 
     }
-    void setVec2(const std::string &name, float x, float y) const
+    void setVec2(const UniformKey &name, float x, float y) const
     { 
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y); 
+        glUniform2f(reflection_.cache().find(name), x, y); 
+    }
+    // 一次上传整个 uniform 数组（如 offsets[100]），name 为数组名
+    void setVec2Array(const UniformKey &name, const glm::vec2 *values, int count) const
+    {
+        glUniform2fv(reflection_.cache().find(name), count, &values[0][0]);
     }
     // ------------------------------------------------------------------------
-    void setVec3(const std::string &name, const glm::vec3 &value) const
+    void setVec3(const UniformKey &name, const glm::vec3 &value) const
     { 
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform3fv(reflection_.cache().find(name), 1, &value[0]); 
     }
-    void setVec3(const std::string &name, float x, float y, float z) const
+    void setVec3(const UniformKey &name, float x, float y, float z) const
     { 
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z); 
+        glUniform3f(reflection_.cache().find(name), x, y, z); 
     }
     // ------------------------------------------------------------------------
-    void setVec4(const std::string &name, const glm::vec4 &value) const
+    void setVec4(const UniformKey &name, const glm::vec4 &value) const
     { 
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform4fv(reflection_.cache().find(name), 1, &value[0]); 
     }
-    void setVec4(const std::string &name, float x, float y, float z, float w) const
+    void setVec4(const UniformKey &name, float x, float y, float z, float w) const
     { 
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w); 
+        glUniform4f(reflection_.cache().find(name), x, y, z, w); 
     }
     // ------------------------------------------------------------------------
-    void setMat2(const std::string &name, const glm::mat2 &mat) const
+    void setMat2(const UniformKey &name, const glm::mat2 &mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix2fv(reflection_.cache().find(name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
-    void setMat3(const std::string &name, const glm::mat3 &mat) const
+    void setMat3(const UniformKey &name, const glm::mat3 &mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix3fv(reflection_.cache().find(name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
-    void setMat4(const std::string &name, const glm::mat4 &mat) const
+    void setMat4(const UniformKey &name, const glm::mat4 &mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(reflection_.cache().find(name), 1, GL_FALSE, &mat[0][0]);
     }
 
 private:
+    friend class ShaderLoader;
+
+    ShaderReflection reflection_;
+
+    // 注入宏并把宏追加到缓存标签中，然后创建程序
+    // ------------------------------------------------------------------------
+    void create(std::string vertexCode, std::string fragmentCode, std::string geometryCode, std::string label, const ShaderDefines& defines)
+    {
+        if (!defines.empty()) {
+            vertexCode   = injectDefines(vertexCode, defines);
+            fragmentCode = injectDefines(fragmentCode, defines);
+            if (!geometryCode.empty()) {
+                geometryCode = injectDefines(geometryCode, defines);
+            }
+        }
+        for (const auto& define : defines) {
+            label += "|" + define.first + (define.second.empty() ? "" : "=" + define.second);
+        }
+        build(vertexCode, fragmentCode, geometryCode, label);
+    }
+
+    // 创建程序：启用二进制缓存时先尝试 glProgramBinary，失败则回退到编译链接并写回缓存
+    // ------------------------------------------------------------------------
+    void build(const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode, const std::string &label)
+    {
+        ProgramBinaryCache& cache = ProgramBinaryCache::instance();
+        if (!cache.enabled()) {
+            ID = glCreateProgram();
+            compileAndLink(vertexCode, fragmentCode, geometryCode);
+            reflection_.build(ID);
+            return;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        uint64_t key = cache.makeKey(vertexCode, fragmentCode, geometryCode);
+
+        ID = glCreateProgram();
+        bool hit = cache.load(ID, label, key);
+        if (!hit) {
+            // glProgramBinary 失败后程序对象不可再用于链接，重新创建
+            glDeleteProgram(ID);
+            ID = glCreateProgram();
+            cache.prepareForLink(ID);
+            if (compileAndLink(vertexCode, fragmentCode, geometryCode)) {
+                cache.store(ID, label, key);
+            }
+        }
+
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        cache.report(label, hit, milliseconds);
+
+        // 链接完成后一次性反射所有活动 uniform、uniform 块与顶点属性
+        reflection_.build(ID);
+    }
+
+    // 编译各阶段着色器并链接到 ID，返回是否链接成功
+    // ------------------------------------------------------------------------
+    bool compileAndLink(const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode)
+    {
+        const char* vShaderCode = vertexCode.c_str();
+        const char* fShaderCode = fragmentCode.c_str();
+        const char* gShaderCode = nullptr;
+        if (!geometryCode.empty()) {
+            gShaderCode = geometryCode.c_str();
+        }
+
+        unsigned int vertex, fragment, geometry;
+        // 顶点着色器
+        vertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertex, 1, &vShaderCode, NULL);
+        glCompileShader(vertex);
+        checkCompileErrors(vertex, "VERTEX");
+        // -------------------------
+
+        // 片段着色器
+        fragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragment, 1, &fShaderCode, NULL);
+        glCompileShader(fragment);
+        checkCompileErrors(fragment, "FRAGMENT");
+        // -------------------------
+
+        // 几何着色器
+        if (gShaderCode != nullptr) {
+            geometry = glCreateShader(GL_GEOMETRY_SHADER);
+            glShaderSource(geometry, 1, &gShaderCode, NULL);
+            glCompileShader(geometry);
+            checkCompileErrors(geometry, "GEOMETRY");
+        }
+
+        // 着色器程序
+        glAttachShader(ID, vertex);
+        glAttachShader(ID, fragment);
+
+        if (gShaderCode != nullptr) {
+            glAttachShader(ID, geometry);
+        }
+    
+        glLinkProgram(ID);
+        bool linked = checkCompileErrors(ID, "PROGRAM");
+        // -------------------------
+
+        // 删除着色器，它们已经链接到程序中了，不再需要
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+
+        if (gShaderCode != nullptr) {
+            glDeleteShader(geometry);
+        }
+        return linked;
+    }
+
     // 检查着色器编译/链接错误的工具函数
     // ------------------------------------------------------------------------
-    void checkCompileErrors(unsigned int shader, std::string type)
+    static bool checkCompileErrors(unsigned int shader, std::string type)
     {
         int success;
         char infoLog[1024];
@@ -199,6 +357,7 @@ private:
                 std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
             }
         }
+        return success;
     }
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,278 @@
+#ifndef SHADER_LOADER_H
+#define SHADER_LOADER_H
+
+#include "Shader.h"
+#include "ProgramBinaryCache.h"
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// 异步着色器创建流水线
+// 1. 读取阶段：源码在工作线程中获取（见 ShaderSource）
+// 2. 编译阶段：渲染线程一次性提交所有就绪程序的编译与链接，不等待结果
+// 3. 轮询阶段：支持 GL_KHR_parallel_shader_compile 时查询 GL_COMPLETION_STATUS_KHR，完成后才检查状态
+// 每个请求返回一个 ShaderHandle，类似 future，用于判断程序是否可用
+struct ShaderLoadState {
+    enum Status {
+        READING,    // 正在工作线程中读取源码
+        COMPILING,  // 已提交编译/链接，等待驱动完成
+        READY,      // 程序可用
+        FAILED      // 读取、编译或链接失败
+    };
+
+    Status status = READING;
+    std::string label;
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::string geometryPath;
+
+    std::future<std::string> vertexSource;
+    std::future<std::string> fragmentSource;
+    std::future<std::string> geometrySource;
+
+    unsigned int vertex = 0;
+    unsigned int fragment = 0;
+    unsigned int geometry = 0;
+    unsigned int program = 0;
+    uint64_t cacheKey = 0;
+    std::chrono::high_resolution_clock::time_point start;
+
+    std::unique_ptr<Shader> shader;
+    std::vector<std::function<void(Shader&)>> callbacks;
+};
+
+class ShaderHandle
+{
+public:
+    ShaderHandle() = default;
+
+    bool ready() const { return state_ && state_->status == ShaderLoadState::READY; }
+    bool failed() const { return !state_ || state_->status == ShaderLoadState::FAILED; }
+
+    // 仅在 ready() 为 true 时调用
+    Shader& get() const { return *state_->shader; }
+
+    // 注册程序可用时执行的回调（在渲染线程的 ShaderLoader::update 中执行）
+    // 若程序已经可用则立即执行
+    void onReady(std::function<void(Shader&)> callback)
+    {
+        if (ready())
+            callback(*state_->shader);
+        else if (state_)
+            state_->callbacks.push_back(std::move(callback));
+    }
+
+private:
+    friend class ShaderLoader;
+    explicit ShaderHandle(std::shared_ptr<ShaderLoadState> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<ShaderLoadState> state_;
+};
+
+class ShaderLoader
+{
+public:
+    ShaderLoader()
+    {
+#ifdef GL_KHR_parallel_shader_compile
+        parallelCompile_ = GLAD_GL_KHR_parallel_shader_compile != 0;
+        if (parallelCompile_) {
+            // 0xFFFFFFFF 表示由驱动决定编译线程数
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        }
+#endif
+    }
+
+    // 发起一个程序的异步创建，立即返回句柄
+    ShaderHandle load(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr)
+    {
+        auto state = std::make_shared<ShaderLoadState>();
+        state->vertexPath = vertexPath;
+        state->fragmentPath = fragmentPath;
+        state->label = state->vertexPath + "|" + state->fragmentPath;
+        if (geometryPath != nullptr) {
+            state->geometryPath = geometryPath;
+            state->label += "|" + state->geometryPath;
+        }
+        state->start = std::chrono::high_resolution_clock::now();
+
+        state->vertexSource = readAsync(state->vertexPath);
+        state->fragmentSource = readAsync(state->fragmentPath);
+        if (geometryPath != nullptr)
+            state->geometrySource = readAsync(state->geometryPath);
+
+        pending_.push_back(state);
+        return ShaderHandle(state);
+    }
+
+    // 每帧在渲染线程调用：先为所有读取完成的请求提交编译，再轮询已提交的程序
+    void update()
+    {
+        for (auto& state : pending_) {
+            if (state->status == ShaderLoadState::READING && sourcesReady(*state))
+                submit(*state);
+        }
+        for (auto& state : pending_) {
+            if (state->status == ShaderLoadState::COMPILING && compileFinished(*state))
+                finish(*state);
+        }
+
+        std::vector<std::shared_ptr<ShaderLoadState>> stillPending;
+        for (auto& state : pending_) {
+            if (state->status == ShaderLoadState::READING || state->status == ShaderLoadState::COMPILING)
+                stillPending.push_back(state);
+        }
+        pending_.swap(stillPending);
+    }
+
+    // 所有请求是否都已完成（成功或失败）
+    bool idle() const { return pending_.empty(); }
+
+    // 阻塞直到所有请求完成
+    void waitAll()
+    {
+        while (!idle()) {
+            update();
+            if (!idle())
+                std::this_thread::yield();
+        }
+    }
+
+private:
+    std::vector<std::shared_ptr<ShaderLoadState>> pending_;
+    bool parallelCompile_ = false;
+
+    // 内嵌源码直接返回，只有覆盖目录或磁盘文件才需要真正的文件读取
+    static std::future<std::string> readAsync(const std::string& path)
+    {
+        return std::async(std::launch::async, [path]() { return ShaderSource::load(path.c_str()); });
+    }
+
+    static bool isReady(const std::future<std::string>& source)
+    {
+        return !source.valid() || source.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    static bool sourcesReady(const ShaderLoadState& state)
+    {
+        return isReady(state.vertexSource) && isReady(state.fragmentSource) && isReady(state.geometrySource);
+    }
+
+    // 提交编译与链接，不查询任何状态
+    void submit(ShaderLoadState& state)
+    {
+        std::string vertexCode, fragmentCode, geometryCode;
+        try
+        {
+            vertexCode = state.vertexSource.get();
+            fragmentCode = state.fragmentSource.get();
+            if (state.geometrySource.valid())
+                geometryCode = state.geometrySource.get();
+        }
+        catch (std::ifstream::failure& e)
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+            std::cout << "QUESTION HAPPEN WITH FILE:" << state.vertexPath << "\t" << state.fragmentPath << std::endl;
+            state.status = ShaderLoadState::FAILED;
+            return;
+        }
+
+        state.program = glCreateProgram();
+
+        // 命中程序二进制缓存时无需编译
+        ProgramBinaryCache& cache = ProgramBinaryCache::instance();
+        if (cache.enabled()) {
+            state.cacheKey = cache.makeKey(vertexCode, fragmentCode, geometryCode);
+            if (cache.load(state.program, state.label, state.cacheKey)) {
+                cache.report(state.label, true, elapsed(state));
+                complete(state);
+                return;
+            }
+            glDeleteProgram(state.program);
+            state.program = glCreateProgram();
+            cache.prepareForLink(state.program);
+        }
+
+        state.vertex = compile(GL_VERTEX_SHADER, vertexCode);
+        state.fragment = compile(GL_FRAGMENT_SHADER, fragmentCode);
+        glAttachShader(state.program, state.vertex);
+        glAttachShader(state.program, state.fragment);
+        if (!geometryCode.empty()) {
+            state.geometry = compile(GL_GEOMETRY_SHADER, geometryCode);
+            glAttachShader(state.program, state.geometry);
+        }
+        glLinkProgram(state.program);
+        state.status = ShaderLoadState::COMPILING;
+    }
+
+    static unsigned int compile(GLenum type, const std::string& code)
+    {
+        unsigned int shader = glCreateShader(type);
+        const char* source = code.c_str();
+        glShaderSource(shader, 1, &source, NULL);
+        glCompileShader(shader);
+        return shader;
+    }
+
+    // 不支持并行编译扩展时，查询链接状态会阻塞，但此时所有程序都已提交
+    bool compileFinished(const ShaderLoadState& state) const
+    {
+#ifdef GL_KHR_parallel_shader_compile
+        if (parallelCompile_) {
+            GLint completed = GL_FALSE;
+            glGetProgramiv(state.program, GL_COMPLETION_STATUS_KHR, &completed);
+            return completed == GL_TRUE;
+        }
+#endif
+        (void)state;
+        return true;
+    }
+
+    void finish(ShaderLoadState& state)
+    {
+        Shader::checkCompileErrors(state.vertex, "VERTEX");
+        Shader::checkCompileErrors(state.fragment, "FRAGMENT");
+        if (state.geometry != 0)
+            Shader::checkCompileErrors(state.geometry, "GEOMETRY");
+        bool linked = Shader::checkCompileErrors(state.program, "PROGRAM");
+
+        glDeleteShader(state.vertex);
+        glDeleteShader(state.fragment);
+        if (state.geometry != 0)
+            glDeleteShader(state.geometry);
+
+        ProgramBinaryCache& cache = ProgramBinaryCache::instance();
+        if (cache.enabled()) {
+            if (linked)
+                cache.store(state.program, state.label, state.cacheKey);
+            cache.report(state.label, false, elapsed(state));
+        }
+
+        if (!linked) {
+            glDeleteProgram(state.program);
+            state.status = ShaderLoadState::FAILED;
+            return;
+        }
+        complete(state);
+    }
+
+    void complete(ShaderLoadState& state)
+    {
+        state.shader.reset(new Shader(state.program));
+        state.status = ShaderLoadState::READY;
+        for (auto& callback : state.callbacks)
+            callback(*state.shader);
+        state.callbacks.clear();
+    }
+
+    static double elapsed(const ShaderLoadState& state)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - state.start).count();
+    }
+};
+
+#endif
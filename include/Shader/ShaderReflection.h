@@ -0,0 +1,269 @@
+#ifndef SHADER_REFLECTION_H
+#define SHADER_REFLECTION_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "UniformCache.h"
+#include "Render/GLStateCache.h"
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// 带类型的 uniform 句柄：链接后解析一次，之后每帧直接使用 location
+template <typename T>
+struct UniformHandle {
+    using value_type = T;
+    GLint location = -1;
+    bool valid() const { return location >= 0; }
+};
+
+// C++ 类型对应的 GL uniform 类型
+template <typename T> struct UniformType;
+template <> struct UniformType<bool>      { static constexpr GLenum value = GL_BOOL; };
+template <> struct UniformType<int>       { static constexpr GLenum value = GL_INT; };
+template <> struct UniformType<float>     { static constexpr GLenum value = GL_FLOAT; };
+template <> struct UniformType<glm::vec2> { static constexpr GLenum value = GL_FLOAT_VEC2; };
+template <> struct UniformType<glm::vec3> { static constexpr GLenum value = GL_FLOAT_VEC3; };
+template <> struct UniformType<glm::vec4> { static constexpr GLenum value = GL_FLOAT_VEC4; };
+template <> struct UniformType<glm::mat2> { static constexpr GLenum value = GL_FLOAT_MAT2; };
+template <> struct UniformType<glm::mat3> { static constexpr GLenum value = GL_FLOAT_MAT3; };
+template <> struct UniformType<glm::mat4> { static constexpr GLenum value = GL_FLOAT_MAT4; };
+
+// 按类型上传 uniform
+inline void uploadUniform(GLint location, bool value)             { glUniform1i(location, (int)value); }
+inline void uploadUniform(GLint location, int value)              { glUniform1i(location, value); }
+inline void uploadUniform(GLint location, float value)            { glUniform1f(location, value); }
+inline void uploadUniform(GLint location, const glm::vec2& value) { glUniform2fv(location, 1, &value[0]); }
+inline void uploadUniform(GLint location, const glm::vec3& value) { glUniform3fv(location, 1, &value[0]); }
+inline void uploadUniform(GLint location, const glm::vec4& value) { glUniform4fv(location, 1, &value[0]); }
+inline void uploadUniform(GLint location, const glm::mat2& value) { glUniformMatrix2fv(location, 1, GL_FALSE, &value[0][0]); }
+inline void uploadUniform(GLint location, const glm::mat3& value) { glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]); }
+inline void uploadUniform(GLint location, const glm::mat4& value) { glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]); }
+
+// uniform 块的全局绑定点表：按块名固定绑定点，所有程序链接时自动调用 glUniformBlockBinding
+// 必须在创建着色器之前注册，例如 UniformBlockBindings::set("Matrices", 0);
+class UniformBlockBindings
+{
+public:
+    static void set(const std::string& blockName, GLuint binding)
+    {
+        table()[blockName] = binding;
+    }
+
+    // 查询块名对应的绑定点，未注册时返回 false
+    static bool get(const std::string& blockName, GLuint& binding)
+    {
+        auto it = table().find(blockName);
+        if (it == table().end())
+            return false;
+        binding = it->second;
+        return true;
+    }
+
+private:
+    static std::map<std::string, GLuint>& table()
+    {
+        static std::map<std::string, GLuint> bindings;
+        return bindings;
+    }
+};
+
+struct UniformInfo {
+    std::string name;
+    GLint location = -1;
+    GLenum type = 0;
+    GLint size = 0;
+    bool isArray = false;
+    GLint textureUnit = -1;     // 采样器自动分配的起始纹理单元，非采样器为 -1
+};
+
+struct UniformBlockInfo {
+    std::string name;
+    GLuint index = 0;
+    GLint dataSize = 0;
+    GLint binding = -1;         // 未在 UniformBlockBindings 中注册时为 -1
+};
+
+struct AttributeInfo {
+    std::string name;
+    GLint location = -1;
+    GLenum type = 0;
+    GLint size = 0;
+};
+
+// 链接期反射：查询活动 uniform、uniform 块与顶点属性，建立反射表
+// 同时为采样器自动分配纹理单元，并按名称为 uniform 块设置绑定点
+class ShaderReflection
+{
+public:
+    std::vector<UniformInfo> uniforms;
+    std::vector<UniformBlockInfo> blocks;
+    std::vector<AttributeInfo> attributes;
+
+    void build(GLuint program)
+    {
+        uniforms.clear();
+        blocks.clear();
+        attributes.clear();
+
+        reflectUniforms(program);
+        reflectBlocks(program);
+        reflectAttributes(program);
+    }
+
+    const UniformLocationCache& cache() const { return cache_; }
+
+    // 按名称查找 uniform 块，找不到返回 nullptr
+    const UniformBlockInfo* findBlock(const std::string& name) const
+    {
+        for (const auto& block : blocks) {
+            if (block.name == name)
+                return &block;
+        }
+        return nullptr;
+    }
+
+    // 按名称查找顶点属性 location，找不到返回 -1
+    GLint attributeLocation(const std::string& name) const
+    {
+        for (const auto& attribute : attributes) {
+            if (attribute.name == name)
+                return attribute.location;
+        }
+        return -1;
+    }
+
+    static bool isSampler(GLenum type)
+    {
+        switch (type) {
+            case GL_SAMPLER_1D:
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+            case GL_SAMPLER_2D_SHADOW:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_2D_MULTISAMPLE:
+            case GL_SAMPLER_BUFFER:
+            case GL_INT_SAMPLER_2D:
+            case GL_UNSIGNED_INT_SAMPLER_2D:
+            case GL_INT_SAMPLER_BUFFER:
+            case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+private:
+    UniformLocationCache cache_;
+
+    void reflectUniforms(GLuint program)
+    {
+        GLint uniformCount = 0;
+        GLint maxNameLength = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+        std::vector<char> buffer(maxNameLength > 0 ? maxNameLength : 1);
+        size_t entryCount = 0;
+        for (GLint i = 0; i < uniformCount; i++) {
+            GLsizei length = 0;
+            UniformInfo info;
+            glGetActiveUniform(program, i, (GLsizei)buffer.size(), &length, &info.size, &info.type, buffer.data());
+            info.name.assign(buffer.data(), length);
+
+            // uniform 块中的成员没有 location，跳过
+            info.location = glGetUniformLocation(program, info.name.c_str());
+            if (info.location < 0)
+                continue;
+
+            // 数组以 "name[0]" 的形式给出，统一记录为数组名
+            size_t bracket = info.name.rfind("[0]");
+            if (bracket != std::string::npos && bracket + 3 == info.name.size()) {
+                info.name.erase(bracket);
+                info.isArray = true;
+            }
+
+            uniforms.push_back(info);
+            entryCount += info.isArray ? info.size + 1 : 1;
+        }
+
+        // 采样器按活动 uniform 的顺序分配连续的纹理单元，并立即写入程序
+        GLint nextUnit = 0;
+        bool programBound = false;
+        for (auto& info : uniforms) {
+            if (!isSampler(info.type))
+                continue;
+            if (!programBound) {
+                GLStateCache::instance().useProgram(program);
+                programBound = true;
+            }
+            info.textureUnit = nextUnit;
+            std::vector<GLint> units(info.size);
+            for (GLint element = 0; element < info.size; element++)
+                units[element] = nextUnit++;
+            glUniform1iv(info.location, info.size, units.data());
+        }
+
+        // 填充哈希表：数组额外登记 "name" 与每个元素 "name[i]"
+        cache_.reset(entryCount);
+        for (const auto& info : uniforms) {
+            cache_.insert(info.name, info.location, info.type, info.textureUnit);
+            if (info.isArray) {
+                for (GLint element = 0; element < info.size; element++) {
+                    std::string elementName = info.name + "[" + std::to_string(element) + "]";
+                    GLint unit = info.textureUnit >= 0 ? info.textureUnit + element : -1;
+                    cache_.insert(elementName, glGetUniformLocation(program, elementName.c_str()), info.type, unit);
+                }
+            }
+        }
+    }
+
+    void reflectBlocks(GLuint program)
+    {
+        GLint blockCount = 0;
+        GLint maxNameLength = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLength);
+
+        std::vector<char> buffer(maxNameLength > 0 ? maxNameLength : 1);
+        for (GLint i = 0; i < blockCount; i++) {
+            GLsizei length = 0;
+            UniformBlockInfo info;
+            info.index = (GLuint)i;
+            glGetActiveUniformBlockName(program, info.index, (GLsizei)buffer.size(), &length, buffer.data());
+            info.name.assign(buffer.data(), length);
+            glGetActiveUniformBlockiv(program, info.index, GL_UNIFORM_BLOCK_DATA_SIZE, &info.dataSize);
+
+            GLuint binding = 0;
+            if (UniformBlockBindings::get(info.name, binding)) {
+                glUniformBlockBinding(program, info.index, binding);
+                info.binding = (GLint)binding;
+            }
+            blocks.push_back(info);
+        }
+    }
+
+    void reflectAttributes(GLuint program)
+    {
+        GLint attributeCount = 0;
+        GLint maxNameLength = 0;
+        glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &attributeCount);
+        glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxNameLength);
+
+        std::vector<char> buffer(maxNameLength > 0 ? maxNameLength : 1);
+        for (GLint i = 0; i < attributeCount; i++) {
+            GLsizei length = 0;
+            AttributeInfo info;
+            glGetActiveAttrib(program, (GLuint)i, (GLsizei)buffer.size(), &length, &info.size, &info.type, buffer.data());
+            info.name.assign(buffer.data(), length);
+            info.location = glGetAttribLocation(program, info.name.c_str());
+            attributes.push_back(info);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef SHADER_SOURCE_H
+#define SHADER_SOURCE_H
+
+#include "EmbeddedShader.h"
+
+#ifdef EMBED_SHADERS
+#include "Shader/EmbeddedShaders.h"
+#endif
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+// 着色器源码的查找顺序：
+// 1. 开发者覆盖目录（环境变量 SHADER_OVERRIDE_DIR 或 setOverrideDirectory()）中的同名文件，修改着色器无需重新构建
+// 2. 构建时内嵌的源码（EMBED_SHADERS 打开时）
+// 3. 按原路径从磁盘读取
+// 以上过程不访问 OpenGL，可在工作线程中调用
+class ShaderSource
+{
+public:
+    // 需要在加载任何着色器之前设置
+    static void setOverrideDirectory(const std::string& directory)
+    {
+        overrideDirectoryStorage() = directory;
+    }
+
+    static const std::string& overrideDirectory()
+    {
+        return overrideDirectoryStorage();
+    }
+
+    // 按文件名查找内嵌源码，路径中的目录部分会被忽略；未内嵌时返回 nullptr
+    static const EmbeddedShader* findEmbedded(std::string_view path)
+    {
+#ifdef EMBED_SHADERS
+        std::string_view name = fileName(path);
+        for (const auto& shader : EmbeddedShaders::all) {
+            if (shader.name == name)
+                return &shader;
+        }
+#else
+        (void)path;
+#endif
+        return nullptr;
+    }
+
+    // 按上述顺序获取源码，全部失败时抛出 std::ifstream::failure
+    static std::string load(const char* path)
+    {
+        std::string overridden;
+        if (readOverride(fileName(path), overridden))
+            return overridden;
+        if (const EmbeddedShader* embedded = findEmbedded(path))
+            return std::string(embedded->source);
+        return readFile(path);
+    }
+
+    // 内嵌源码同样可以被覆盖目录中的同名文件替换
+    static std::string load(const EmbeddedShader& shader)
+    {
+        std::string overridden;
+        if (readOverride(shader.name, overridden))
+            return overridden;
+        return std::string(shader.source);
+    }
+
+    // 读取整个着色器文件，失败时抛出 std::ifstream::failure
+    static std::string readFile(const char* path)
+    {
+        std::ifstream file;
+        // 确保ifstream对象可以抛出异常：
+        file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
+        file.open(path);
+        std::stringstream stream;
+        // 读取文件缓冲内容到数据流
+        stream << file.rdbuf();
+        file.close();
+        return stream.str();
+    }
+
+private:
+    static std::string& overrideDirectoryStorage()
+    {
+        static std::string directory = []() {
+            const char* value = std::getenv("SHADER_OVERRIDE_DIR");
+            return std::string(value ? value : "");
+        }();
+        return directory;
+    }
+
+    static std::string_view fileName(std::string_view path)
+    {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string_view::npos ? path : path.substr(slash + 1);
+    }
+
+    static bool readOverride(std::string_view name, std::string& source)
+    {
+        const std::string& directory = overrideDirectory();
+        if (directory.empty())
+            return false;
+
+        std::ifstream file(directory + "/" + std::string(name));
+        if (!file.is_open())
+            return false;
+        std::stringstream stream;
+        stream << file.rdbuf();
+        source = stream.str();
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include "Shader.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 一个着色器变体：源码文件组合 + 宏集合
+struct ShaderVariantDesc {
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::string geometryPath;   // 为空表示没有几何着色器
+    ShaderDefines defines;
+};
+
+// 着色器变体缓存：每个 (源码组合, 宏集合) 只编译一次，以稳定哈希为键
+// get() 在首次使用时才编译；prewarm()/loadManifest() 可在场景加载时预先编译所需变体，避免首次使用时卡顿
+class ShaderVariantCache
+{
+public:
+    // 获取变体，不存在时立即编译
+    Shader& get(const ShaderVariantDesc& desc)
+    {
+        uint64_t key = hashVariant(desc);
+        auto it = variants_.find(key);
+        if (it != variants_.end())
+            return *it->second;
+
+        const char* geometryPath = desc.geometryPath.empty() ? nullptr : desc.geometryPath.c_str();
+        std::unique_ptr<Shader> shader(new Shader(desc.vertexPath.c_str(), desc.fragmentPath.c_str(), geometryPath, desc.defines));
+        Shader& result = *shader;
+        variants_.emplace(key, std::move(shader));
+        return result;
+    }
+
+    Shader& get(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr, const ShaderDefines& defines = ShaderDefines())
+    {
+        return get(ShaderVariantDesc{ vertexPath, fragmentPath, geometryPath ? geometryPath : "", defines });
+    }
+
+    bool contains(const ShaderVariantDesc& desc) const
+    {
+        return variants_.find(hashVariant(desc)) != variants_.end();
+    }
+
+    // 预编译一组变体
+    void prewarm(const std::vector<ShaderVariantDesc>& manifest)
+    {
+        for (const auto& desc : manifest)
+            get(desc);
+    }
+
+    // 从清单文件预编译变体，每行一个变体：
+    //     顶点着色器 片段着色器 [几何着色器] [ : 宏1=值 宏2 ...]
+    // 文件与宏之间用两侧带空格的 " : " 分隔（路径中可以有盘符冒号），宏之间以括号外的空白分隔，
+    // 因此值可以写成 COLOR=vec3(1.0, 0.0, 0.0)，与代码中的描述得到相同的哈希；以 # 开头的行为注释
+    bool loadManifest(const char* path)
+    {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            std::cout << "ERROR::SHADER_VARIANTS::MANIFEST_NOT_FOUND: " << path << std::endl;
+            return false;
+        }
+        std::vector<ShaderVariantDesc> manifest;
+        std::string line;
+        while (std::getline(file, line)) {
+            ShaderVariantDesc desc;
+            if (parseManifestLine(line, desc))
+                manifest.push_back(desc);
+        }
+        prewarm(manifest);
+        return true;
+    }
+
+    size_t size() const { return variants_.size(); }
+
+    // 变体的稳定哈希（FNV-1a 64），与插入顺序和运行次数无关
+    static uint64_t hashVariant(const ShaderVariantDesc& desc)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        hash = hashString(hash, desc.vertexPath);
+        hash = hashString(hash, desc.fragmentPath);
+        hash = hashString(hash, desc.geometryPath);
+        for (const auto& define : desc.defines) {
+            hash = hashString(hash, define.first);
+            hash = hashString(hash, define.second);
+        }
+        return hash;
+    }
+
+private:
+    std::unordered_map<uint64_t, std::unique_ptr<Shader>> variants_;
+
+    static uint64_t hashString(uint64_t hash, const std::string& value)
+    {
+        for (char c : value) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        // 分隔符，避免 "ab"+"c" 与 "a"+"bc" 冲突
+        hash ^= 0xFF;
+        hash *= 1099511628211ull;
+        return hash;
+    }
+
+    static bool parseManifestLine(const std::string& line, ShaderVariantDesc& desc)
+    {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            return false;
+
+        std::string files = line;
+        std::string defines;
+        size_t colon = line.rfind(" : ");
+        if (colon != std::string::npos) {
+            files = line.substr(0, colon);
+            defines = line.substr(colon + 3);
+        }
+
+        std::istringstream fileStream(files);
+        fileStream >> desc.vertexPath >> desc.fragmentPath >> desc.geometryPath;
+        if (desc.vertexPath.empty() || desc.fragmentPath.empty())
+            return false;
+
+        for (const std::string& define : splitDefines(defines)) {
+            size_t equal = define.find('=');
+            if (equal == std::string::npos)
+                desc.defines[define] = "";
+            else
+                desc.defines[define.substr(0, equal)] = define.substr(equal + 1);
+        }
+        return true;
+    }
+
+    // 按括号外的空白切分宏，括号内的空白保留在值中
+    static std::vector<std::string> splitDefines(const std::string& defines)
+    {
+        std::vector<std::string> result;
+        std::string current;
+        int depth = 0;
+        for (char c : defines) {
+            if (c == '(')
+                depth++;
+            else if (c == ')' && depth > 0)
+                depth--;
+            if (depth == 0 && (c == ' ' || c == '\t' || c == '\r')) {
+                if (!current.empty())
+                    result.push_back(current);
+                current.clear();
+                continue;
+            }
+            current += c;
+        }
+        if (!current.empty())
+            result.push_back(current);
+        return result;
+    }
+};
+
+#endif
@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 FragColor;
+
+// 颜色由宏 COLOR 指定，例如 COLOR=vec3(1.0, 0.0, 0.0)
+#ifndef COLOR
+#define COLOR vec3(1.0, 1.0, 0.0)
+#endif
+
+void main()
+{
+    FragColor = vec4(COLOR, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#ifndef UNIFORM_CACHE_H
+#define UNIFORM_CACHE_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// FNV-1a 32 位哈希，constexpr 以便在编译期为字面量预先计算
+constexpr uint32_t hashUniformName(const char* name)
+{
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= static_cast<uint8_t>(*name++);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// uniform 名称键：保存名称指针和预先计算的哈希值
+// 可由 const char* / std::string 隐式构造；声明为 constexpr 时哈希在编译期完成
+//     static constexpr UniformKey MODEL("model");
+//     shader.setMat4(MODEL, model);
+struct UniformKey {
+    const char* name;
+    uint32_t hash;
+
+    constexpr UniformKey(const char* n) : name(n), hash(hashUniformName(n)) {}
+    UniformKey(const std::string& n) : name(n.c_str()), hash(hashUniformName(n.c_str())) {}
+};
+
+// uniform 查询结果：location、GL 类型，以及采样器对应的纹理单元（非采样器为 -1）
+struct UniformEntry {
+    std::string name;
+    uint32_t hash = 0;
+    GLint location = -1;
+    GLenum type = 0;
+    GLint textureUnit = -1;
+    bool used = false;
+};
+
+// uniform location 缓存：链接后由 ShaderReflection 从程序的活动 uniform 一次性填充
+// 使用开放寻址哈希表，查询过程不分配内存
+class UniformLocationCache
+{
+public:
+    // 清空并按预计元素数分配容量（取不小于两倍元素数的 2 的幂，保证探测链较短）
+    void reset(size_t expectedCount)
+    {
+        size_t capacity = 16;
+        while (capacity < expectedCount * 2)
+            capacity <<= 1;
+        entries_.assign(capacity, UniformEntry());
+        mask_ = capacity - 1;
+        count_ = 0;
+    }
+
+    void insert(const std::string& name, GLint location, GLenum type, GLint textureUnit = -1)
+    {
+        uint32_t hash = hashUniformName(name.c_str());
+        size_t index = hash & mask_;
+        while (entries_[index].used) {
+            if (entries_[index].hash == hash && entries_[index].name == name)
+                return;
+            index = (index + 1) & mask_;
+        }
+        UniformEntry& entry = entries_[index];
+        entry.name = name;
+        entry.hash = hash;
+        entry.location = location;
+        entry.type = type;
+        entry.textureUnit = textureUnit;
+        entry.used = true;
+        count_++;
+    }
+
+    // 查询完整条目，找不到时返回 nullptr
+    const UniformEntry* lookup(const UniformKey& key) const
+    {
+        if (entries_.empty())
+            return nullptr;
+
+        size_t index = key.hash & mask_;
+        while (entries_[index].used) {
+            const UniformEntry& entry = entries_[index];
+            if (entry.hash == key.hash && std::strcmp(entry.name.c_str(), key.name) == 0)
+                return &entry;
+            index = (index + 1) & mask_;
+        }
+        return nullptr;
+    }
+
+    // 查询 uniform location，找不到时返回 -1（与 glGetUniformLocation 一致，glUniform* 会忽略 -1）
+    GLint find(const UniformKey& key) const
+    {
+        const UniformEntry* entry = lookup(key);
+        return entry ? entry->location : -1;
+    }
+
+    size_t size() const { return count_; }
+
+private:
+    std::vector<UniformEntry> entries_;
+    size_t mask_ = 0;
+    size_t count_ = 0;
+};
+
+#endif
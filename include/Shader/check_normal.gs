@@ -7,7 +7,11 @@ in VS_OUT {
 } gs_in[];
 
 uniform float normal_offset;
-uniform mat4 projection;
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
 
 void generateNormalLine(int index)
 {
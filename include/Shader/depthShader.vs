@@ -0,0 +1,19 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+layout (std140) uniform Object
+{
+    mat4 model;
+    mat4 normalMatrix;
+};
+
+// 深度预渲染/阴影通道：只读取位置流
+void main()
+{
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
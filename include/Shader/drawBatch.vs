@@ -0,0 +1,23 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 8) in uint aDrawId;      // GeometryArena::DRAW_ID_LOCATION，即网格在批次中的下标
+
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+// 逐绘制模型矩阵：每个 drawId 3 个 RGBA32F 纹素，为 3x4 行主序仿射矩阵
+uniform samplerBuffer drawTransforms;
+
+void main()
+{
+    int base = int(aDrawId) * 3;
+    mat4 model = transpose(mat4(texelFetch(drawTransforms, base),
+                                texelFetch(drawTransforms, base + 1),
+                                texelFetch(drawTransforms, base + 2),
+                                vec4(0.0, 0.0, 0.0, 1.0)));
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
@@ -12,12 +12,19 @@ out VS_OUT {
     vec3 normal;
 } vs_out;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat3 normalMatrix;
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+layout (std140) uniform Object
+{
+    mat4 model;
+    mat4 normalMatrix;
+};
 
 void main() 
 {
     gl_Position = view * model * vec4(aPos, 1.0);
-    vs_out.normal = normalize(vec3(vec4(normalMatrix * aNormal, 0.0)));
+    vs_out.normal = normalize(mat3(normalMatrix) * aNormal);
 }
\ No newline at end of file
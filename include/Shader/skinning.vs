@@ -0,0 +1,60 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in vec3 aColor;
+layout (location = 4) in vec3 aTangent;
+layout (location = 5) in vec3 aBitangent;
+layout (location = 6) in ivec4 aBoneIds;     // 整数属性（glVertexAttribIPointer），紧凑格式下为 0~255
+layout (location = 7) in vec4 aWeights;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+out vec3 VertexColor;
+
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+layout (std140) uniform Object
+{
+    mat4 model;
+    mat4 normalMatrix;
+};
+
+// 骨骼调色板：每根骨骼 3 个 RGBA32F 纹素，为 3x4 行主序仿射矩阵（BonePaletteBuffer）
+uniform samplerBuffer bonePalette;
+uniform int paletteOffset;      // 本角色第一根骨骼在调色板中的下标
+
+mat4 boneMatrix(int bone)
+{
+    int base = (paletteOffset + bone) * 3;
+    vec4 row0 = texelFetch(bonePalette, base + 0);
+    vec4 row1 = texelFetch(bonePalette, base + 1);
+    vec4 row2 = texelFetch(bonePalette, base + 2);
+    return transpose(mat4(row0, row1, row2, vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
+void main()
+{
+    // 权重总和为 0 的顶点不受骨骼影响
+    mat4 skin = mat4(0.0);
+    float total = 0.0;
+    for (int i = 0; i < 4; i++) {
+        if (aWeights[i] > 0.0) {
+            skin += boneMatrix(aBoneIds[i]) * aWeights[i];
+            total += aWeights[i];
+        }
+    }
+    if (total <= 0.0)
+        skin = mat4(1.0);
+
+    vec4 position = skin * vec4(aPos, 1.0);
+    gl_Position = projection * view * model * position;
+    FragPos = vec3(model * position);
+    Normal = mat3(normalMatrix) * (mat3(skin) * aNormal);
+    TexCoords = aTexCoords;
+    VertexColor = aColor;
+}
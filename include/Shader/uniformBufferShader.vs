@@ -19,13 +19,16 @@ layout (std140) uniform Matrices
     mat4 projection;
     mat4 view;
 };
-uniform mat4 model;
-uniform mat3 normalMatrix;
+layout (std140) uniform Object
+{
+    mat4 model;
+    mat4 normalMatrix;
+};
 
 void main()
 {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
     TexCoords = aTexCoords;
     Position = vec3(model * vec4(aPos, 1.0));
-    Normal = normalMatrix * aNormal;
+    Normal = mat3(normalMatrix) * aNormal;
 }
\ No newline at end of file
@@ -16,19 +16,36 @@ public:
     float getDepth() const { return depth_; }
     
     // 主要接口：设置立方体参数接口，并会调用相应接口进行绘制
+    // 已生成过网格时只按新尺寸改写顶点位置并原地更新顶点缓冲，不重建缓冲，也不重新优化
+    // 这里不用模型矩阵缩放：非均匀缩放会改变法线矩阵，与按尺寸生成的平滑法线不一致
     void setSize(float width, float height, float depth) {
         width_ = width;
         height_ = height;
         depth_ = depth;
         
-        // 自动调用绘制函数
-        generateGeometry();
+        if (getMesh().vertexCount == 0 || unitPositions_.size() != getVertices().size()) {
+            generateGeometry();
+            return;
+        }
+        applySize();
+        if (!updateBuffers()) {
+            std::cout << "Error: Failed to update Cuboid's Buffers" << std::endl;
+        }
     }
 
 private:
     float width_;
     float height_;
     float depth_;
+    std::vector<glm::vec3> unitPositions_;  // 优化重排后各顶点在单位立方体上的位置
+    
+    void applySize() {
+        auto& vertices = getVertices();
+        glm::vec3 size(width_, height_, depth_);
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            vertices[i].position = unitPositions_[i] * size;
+        }
+    }
     
     void generateGeometry() {
         clear();
@@ -36,9 +53,10 @@ private:
         auto& vertices = getVertices();
         auto& indices = getIndices();
         
-        float halfW = width_ * 0.5f;
-        float halfH = height_ * 0.5f;
-        float halfD = depth_ * 0.5f;
+        // 先生成单位立方体，优化后记录单位位置，再按尺寸缩放
+        float halfW = 0.5f;
+        float halfH = 0.5f;
+        float halfD = 0.5f;
         
         // 8个顶点
         glm::vec3 positions[8] = {
@@ -98,6 +116,14 @@ private:
             // 添加2个三角形（逆时针）顶点到 indices 中
             indices.insert(indices.end(), {baseIndex, baseIndex + 1, baseIndex + 2, baseIndex, baseIndex + 2, baseIndex + 3});
         }
+        optimizeMesh("GEOMETRY::CUBOID");
+        unitPositions_.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            unitPositions_[i] = vertices[i].position;
+        }
+        applySize();
+        // 每个面的切线沿坐标轴方向，不随 setSize 的按轴缩放改变，只在这里生成一次
+        generateTangents("GEOMETRY::CUBOID");
         if (!initBuffers()) {
             std::cout << "Error: Failed to init Cuboid's Buffers" << std::endl;
         }
@@ -2,6 +2,7 @@
 #define GEOMETRY_H
 
 #include "Mesh.h"
+#include "Render/FrameUniforms.h"
 
 #include <iostream>
 #include <memory>
@@ -15,7 +16,12 @@ public:
         UNKNOWN                 // 其他未知几何体
     };
 
-    Geometry(Type type = UNKNOWN) : type_(type) {}
+    // 程序生成的几何体有位置、法线、纹理坐标、颜色与切线空间（由 generateTangents 生成），不上传骨骼数据
+    Geometry(Type type = UNKNOWN) : type_(type) {
+        mesh_.attributeMask = VertexLayout::POSITION_BIT | VertexLayout::NORMAL_BIT
+                            | VertexLayout::TEXCOORD_BIT | VertexLayout::COLOR_BIT
+                            | VertexLayout::TANGENT_BIT | VertexLayout::BITANGENT_BIT;
+    }
     virtual ~Geometry();
 
     // 禁止拷贝（因为管理OpenGL资源）
@@ -39,10 +45,83 @@ public:
         return mesh_.setupBuffers();
     }
     
+    // 修改 getVertices() 中的顶点后调用（顶点数与索引不变）：原地更新已有缓冲，不重建 VAO/VBO/EBO
+    bool updateBuffers() {
+        return mesh_.updateVertices();
+    }
+    
+    // 生成顶点与索引后、上传前调用：合并全部属性相同（epsilon > 0 时为量化后相同）的重复顶点并改写索引
+    // 输出焊接前后的顶点数
+    void weldVertices(const char* label, float epsilon = 0.0f) {
+        VertexWelder::weld(mesh_.vertices, mesh_.indices, epsilon).print(label);
+    }
+    
+    // 生成顶点与索引后、上传前调用：由位置、法线与纹理坐标生成切线与副切线（TangentGenerator）
+    void generateTangents(const char* label) {
+        TangentGenerator::generate(mesh_.vertices, mesh_.indices).print(label);
+    }
+    
+    // 生成顶点与索引后、上传前调用：按后变换缓存与过度绘制重排三角形，按首次使用顺序重排顶点
+    // 并输出优化前后的 ACMR / ATVR
+    void optimizeMesh(const char* label) {
+        MeshOptimizer::optimize(mesh_.vertices, mesh_.indices).print(label);
+    }
+    
+    // 修改顶点属性与存储格式，已上传时重新生成缓冲区
+    void setVertexLayout(uint32_t attributes, VertexFormat format = VertexFormat::FULL) {
+        mesh_.attributeMask = attributes;
+        mesh_.vertexFormat = format;
+        if (mesh_.VAO != 0 || mesh_.arenaHandle != GeometryArena::INVALID_HANDLE) {
+            initBuffers();
+        }
+    }
+    
     // 渲染几何体
-    void render(Shader shader) const {
+    void render(const Shader& shader) const {
         mesh_.render(shader);
     }
+
+    // 深度/阴影通道，调用前需激活深度着色器
+    void renderDepth() const {
+        mesh_.renderDepth();
+    }
+
+    // 是否额外生成深度通道使用的位置流，已上传时重新生成缓冲区
+    void setPositionStream(bool enabled) {
+        mesh_.keepPositionStream = enabled;
+        if (mesh_.VAO != 0 || mesh_.arenaHandle != GeometryArena::INVALID_HANDLE) {
+            initBuffers();
+        }
+    }
+    
+    // 是否生成简化的细节级别（共享顶点缓冲），已上传时重新生成缓冲区
+    void setLodChain(bool enabled) {
+        mesh_.buildLods = enabled;
+        if (mesh_.VAO != 0 || mesh_.arenaHandle != GeometryArena::INVALID_HANDLE) {
+            initBuffers();
+        }
+    }
+
+    // 按屏幕空间误差选择细节级别渲染，selector 由 LodSelector::create(..., getModelMatrix(), ...) 生成
+    void renderLod(const Shader& shader, const LodSelector& selector) const {
+        mesh_.renderLod(shader, selector.select(mesh_.lods, mesh_.boundsCenter, mesh_.boundsRadius));
+    }
+
+    // 是否从 GeometryArena 的共享缓冲中子分配，已上传时重新生成缓冲区
+    void setUseArena(bool enabled) {
+        mesh_.useArena = enabled;
+        if (mesh_.VAO != 0 || mesh_.arenaHandle != GeometryArena::INVALID_HANDLE) {
+            initBuffers();
+        }
+    }
+    
+    // 是否每帧更新顶点：顶点缓冲改为持久映射的流式缓冲（三段轮换），已上传时重新生成缓冲区
+    void setDynamic(bool enabled) {
+        mesh_.dynamicVertices = enabled;
+        if (mesh_.VAO != 0 || mesh_.arenaHandle != GeometryArena::INVALID_HANDLE) {
+            initBuffers();
+        }
+    }
     
     // 变换相关接口
     void setPosition(const glm::vec3& position);
@@ -54,6 +133,8 @@ public:
     glm::vec3 getScale() const { return scale_; }
     glm::vec3 getRotation() const { return rotation_; }
     glm::mat4 getModelMatrix() const;
+    // Object uniform 块的数据（模型矩阵与世界空间法线矩阵），写入 UniformRing 后绑定到 OBJECT_BLOCK_BINDING
+    ObjectUniforms getObjectUniforms() const;
     
     // 清空几何体数据
     void clear() {
@@ -68,6 +149,7 @@ protected:
     glm::vec3 position_ = glm::vec3(0.0f);   // 几何体偏移
     glm::vec3 scale_ = glm::vec3(1.0f);      // 几何体缩放
     glm::vec3 rotation_ = glm::vec3(0.0f);   // 几何体欧拉角
+    glm::vec3 shapeScale_ = glm::vec3(1.0f); // 形状参数（如球半径）对应的缩放，乘在 scale_ 之后，不修改顶点
     
     // 矩阵变换相关
     mutable bool modelMatrixDirty_ = false;
@@ -77,6 +159,12 @@ protected:
     void markModelMatrixDirty() {
         modelMatrixDirty_ = true;
     }
+
+    // 子类以单位尺寸生成网格时，把形状参数折算为模型矩阵的缩放
+    void setShapeScale(const glm::vec3& scale) {
+        shapeScale_ = scale;
+        markModelMatrixDirty();
+    }
 };
 
 // 实现移动到.cpp文件中
@@ -90,6 +178,7 @@ Geometry::Geometry(Geometry&& other) noexcept
       position_(other.position_),
       scale_(other.scale_),
       rotation_(other.rotation_),
+      shapeScale_(other.shapeScale_),
       modelMatrixDirty_(other.modelMatrixDirty_),
       modelMatrix_(other.modelMatrix_) {
     // 重置源对象
@@ -107,6 +196,7 @@ Geometry& Geometry::operator=(Geometry&& other) noexcept {
         position_ = other.position_;
         scale_ = other.scale_;
         rotation_ = other.rotation_;
+        shapeScale_ = other.shapeScale_;
         modelMatrixDirty_ = other.modelMatrixDirty_;
         modelMatrix_ = other.modelMatrix_;
         
@@ -142,11 +232,18 @@ glm::mat4 Geometry::getModelMatrix() const {
         modelMatrix_ = glm::rotate(modelMatrix_, glm::radians(rotation_.y), glm::vec3(0.0f, 1.0f, 0.0f));
         modelMatrix_ = glm::rotate(modelMatrix_, glm::radians(rotation_.z), glm::vec3(0.0f, 0.0f, 1.0f));
         
-        modelMatrix_ = glm::scale(modelMatrix_, scale_);
+        modelMatrix_ = glm::scale(modelMatrix_, scale_ * shapeScale_);
         
         modelMatrixDirty_ = false;
     }
     return modelMatrix_;
 }
 
-#endif
\ No newline at end of file
+ObjectUniforms Geometry::getObjectUniforms() const {
+    ObjectUniforms uniforms;
+    uniforms.model = getModelMatrix();
+    uniforms.normalMatrix = glm::mat4(glm::transpose(glm::inverse(glm::mat3(uniforms.model))));
+    return uniforms;
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef INDEX_FORMAT_H
+#define INDEX_FORMAT_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// 索引宽度：上传时按顶点数选择能容纳所有索引的最窄类型，CPU 端统一保存为 unsigned int
+// 注意部分驱动会在上传时把 8 位索引转换为 16 位，显存节省以驱动实际行为为准
+struct IndexFormat {
+    static GLenum chooseType(size_t vertexCount)
+    {
+        if (vertexCount <= 0xFFu + 1u)
+            return GL_UNSIGNED_BYTE;
+        if (vertexCount <= 0xFFFFu + 1u)
+            return GL_UNSIGNED_SHORT;
+        return GL_UNSIGNED_INT;
+    }
+
+    static size_t typeSize(GLenum type)
+    {
+        switch (type) {
+            case GL_UNSIGNED_BYTE:  return 1;
+            case GL_UNSIGNED_SHORT: return 2;
+            default:                return 4;
+        }
+    }
+
+    // 把索引转换为 type 对应宽度的紧凑数组
+    static std::vector<unsigned char> pack(const std::vector<unsigned int>& indices, GLenum type)
+    {
+        std::vector<unsigned char> data(indices.size() * typeSize(type));
+        switch (type) {
+            case GL_UNSIGNED_BYTE:
+                for (size_t i = 0; i < indices.size(); i++)
+                    data[i] = (uint8_t)indices[i];
+                break;
+            case GL_UNSIGNED_SHORT: {
+                uint16_t* out = reinterpret_cast<uint16_t*>(data.data());
+                for (size_t i = 0; i < indices.size(); i++)
+                    out[i] = (uint16_t)indices[i];
+                break;
+            }
+            default:
+                if (!indices.empty())
+                    std::memcpy(data.data(), indices.data(), data.size());
+                break;
+        }
+        return data;
+    }
+
+    // 选择宽度并上传到当前绑定的 GL_ELEMENT_ARRAY_BUFFER，返回所用类型
+    static GLenum upload(const std::vector<unsigned int>& indices, size_t vertexCount, size_t* uploadedBytes = nullptr)
+    {
+        GLenum type = chooseType(vertexCount);
+        std::vector<unsigned char> data = pack(indices, type);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.size(), data.data(), GL_STATIC_DRAW);
+        if (uploadedBytes)
+            *uploadedBytes = data.size();
+        return type;
+    }
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 只读内存映射文件：文件页由操作系统按需读入，不经过额外的读缓冲拷贝
+// Windows 使用 CreateFileMapping / MapViewOfFile，其他平台使用 mmap
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path)
+    {
+        close();
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file_ == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_, &size) || size.QuadPart <= 0) {
+            close();
+            return false;
+        }
+        mapping_ = CreateFileMappingA(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping_ == NULL) {
+            close();
+            return false;
+        }
+        data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (data_ == nullptr) {
+            close();
+            return false;
+        }
+        size_ = (size_t)size.QuadPart;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        void* address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // 映射建立后文件描述符即可关闭，映射本身保持有效
+        ::close(fd);
+        if (address == MAP_FAILED)
+            return false;
+        data_ = static_cast<const unsigned char*>(address);
+        size_ = (size_t)info.st_size;
+#endif
+        return true;
+    }
+
+    void close()
+    {
+#ifdef _WIN32
+        if (data_)
+            UnmapViewOfFile(data_);
+        if (mapping_ != NULL)
+            CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE)
+            CloseHandle(file_);
+        mapping_ = NULL;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_)
+            munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    // 映射前已在页缓存中的比例（0 ~ 1），用于区分冷启动与热启动；无法查询时返回 -1
+    // 必须在读取映射内容之前调用，读取后所有页都已驻留
+    float residentFraction() const
+    {
+#if defined(_WIN32)
+        return -1.0f;
+#else
+        if (data_ == nullptr)
+            return -1.0f;
+        size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+        std::vector<unsigned char> pages((size_ + pageSize - 1) / pageSize);
+    #ifdef __APPLE__
+        if (mincore(const_cast<unsigned char*>(data_), size_, reinterpret_cast<char*>(pages.data())) != 0)
+    #else
+        if (mincore(const_cast<unsigned char*>(data_), size_, pages.data()) != 0)
+    #endif
+            return -1.0f;
+        size_t resident = 0;
+        for (unsigned char page : pages)
+            resident += page & 1;
+        return pages.empty() ? -1.0f : (float)resident / pages.size();
+#endif
+    }
+
+    const unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool valid() const { return data_ != nullptr; }
+
+private:
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = NULL;
+#endif
+};
+
+#endif
@@ -3,10 +3,21 @@
 
 #include "Shader/Shader.h"
 #include "Vertex.h"
+#include "VertexLayout.h"
+#include "PositionStream.h"
+#include "IndexFormat.h"
+#include "MeshOptimizer.h"
+#include "VertexWelder.h"
+#include "TangentGenerator.h"
+#include "Meshlet.h"
+#include "MeshSimplifier.h"
+#include "Render/GeometryArena.h"
+#include "Render/StreamingVertexBuffer.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
 #include <string>
+#include <cstdio>
 
 struct Texture {
     unsigned int id;
@@ -14,29 +25,114 @@ struct Texture {
     std::string path;
 };
 
+// 网格上传选项（Model 导入与 Geometry 生成时使用）
+struct MeshOptions {
+    VertexFormat vertexFormat = VertexFormat::FULL;
+    bool positionStream = false;    // 额外生成紧凑的位置流与深度 VAO，供深度预渲染/阴影通道使用
+    bool splitLargeMeshes = false;  // Model 导入时把超过 maxVerticesPerMesh 的网格拆分，使每块都能使用 16 位索引
+    size_t maxVerticesPerMesh = 65536;
+    bool weldVertices = true;           // Model 导入时合并全部属性相同的重复顶点（VertexWelder）
+    float weldEpsilon = 0.0f;           // 焊接容差，0 为精确比较；大于 0 时浮点属性按该步长量化后比较
+    bool optimizeVertexCache = true;    // Model 导入时按后变换缓存、过度绘制与顶点拉取顺序重排（MeshOptimizer）
+    bool useArena = false;              // 从 GeometryArena 的共享缓冲中子分配，不再创建独立的 VAO/VBO/EBO
+    bool meshlets = false;              // 分成至多 64 顶点 / 124 三角形的簇，供 renderCulled() 做簇级剔除
+    bool lodChain = false;              // 生成 50% / 25% / 12.5% 的简化索引（共享顶点缓冲），供 renderLod() 按屏幕误差选择
+    bool cpuAccess = false;             // 上传后保留 CPU 端的顶点与索引（需要读取或重新上传时），否则上传后释放
+    bool dynamicVertices = false;       // 顶点会频繁更新：顶点缓冲使用 StreamingVertexBuffer（持久映射），不进入 GeometryArena
+    bool compressAnimations = true;     // Model 导入时把动画片段压缩为 CompressedClip 并释放重采样的原始帧
+};
+
 // 立体图形网格结构体：统一封装顶点数据和三角形索引
 // 一个Mesh对应一个完整3D图形，并支持VAO/VBO/EBO
 struct Mesh {
     std::vector<Vertex> vertices;      // 顶点列表（存储所有唯一顶点）
     std::vector<unsigned int> indices;
     std::vector<Texture> textures;
+
+    // 驻留策略：keepCpuData 为 false 时上传成功后释放 vertices / indices，之后只能绘制，不能重新上传
+    bool keepCpuData = true;
+    size_t vertexCount = 0;             // 上传的顶点数，释放 CPU 数据后仍可用
     
     // OpenGL对象ID
     GLuint VAO = 0;
     GLuint VBO = 0;
     GLuint EBO = 0;
+
+    // 顶点在 GPU 上的存储格式与网格实际拥有的属性（VertexLayout::Mask），上传时据此生成布局
+    VertexFormat vertexFormat = VertexFormat::FULL;
+    uint32_t attributeMask = VertexLayout::ALL_BITS;
+    VertexLayout layout;
+    size_t vertexBufferSize = 0;    // 实际上传的顶点缓冲大小（字节）
+
+    // 上传时按顶点数选择的索引宽度（GL_UNSIGNED_BYTE / SHORT / INT）
+    GLenum indexType = GL_UNSIGNED_INT;
+    size_t indexBufferSize = 0;
+
+    // 动态顶点：顶点缓冲由 streamingVertices 持有，此时 VBO 为 0，绘制时加上当前段的 baseVertex
+    bool dynamicVertices = false;
+    StreamingVertexBuffer streamingVertices;
+
+    // 位于 GeometryArena 时的区间记录，此时 VAO/VBO/EBO 均为 0
+    bool useArena = false;
+    GeometryArena::Handle arenaHandle = GeometryArena::INVALID_HANDLE;
+
+    // 簇与簇级剔除时的绘制列表（buildMeshlets 为 true 时生成）
+    bool buildMeshlets = false;
+    std::vector<Meshlet> meshlets;
+    mutable std::vector<GLsizei> drawCounts;
+    mutable std::vector<const void*> drawOffsets;
+    mutable std::vector<GLint> drawBaseVertices;
+
+    // 细节级别：lods[0] 为原网格，其余级别的索引追加在同一索引缓冲之后（buildLods 为 true 时生成）
+    bool buildLods = false;
+    std::vector<LodLevel> lods;
+    glm::vec3 boundsCenter = glm::vec3(0.0f);   // 包围球（模型空间），用于选择细节级别
+    float boundsRadius = 0.0f;
+
+    // 深度通道使用的位置流（keepPositionStream 为 true 时生成）
+    bool keepPositionStream = false;
+    PositionStream positionStream;
+
+    // 每张纹理在当前程序中的纹理单元（按程序缓存，切换程序时重新解析）
+    mutable unsigned int samplerProgram = 0;
+    mutable std::vector<GLint> samplerUnits;
     
     Mesh() = default;
 
-    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures)
+    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures,
+         const MeshOptions& options = MeshOptions(), uint32_t attributes = VertexLayout::ALL_BITS)
     {
-        this->vertices  = vertices;
-        this->indices   = indices;
-        this->textures  = textures;
+        // 参数按值传入，调用方用 std::move 传入时全程不发生拷贝
+        this->vertices  = std::move(vertices);
+        this->indices   = std::move(indices);
+        this->textures  = std::move(textures);
+        this->keepCpuData = options.cpuAccess;
+        this->vertexFormat = options.vertexFormat;
+        this->keepPositionStream = options.positionStream;
+        this->useArena = options.useArena;
+        this->dynamicVertices = options.dynamicVertices;
+        this->buildMeshlets = options.meshlets;
+        this->buildLods = options.lodChain;
+        this->attributeMask = attributes;
 
         setupBuffers();
     }
-    
+
+    // 由已按布局打包的顶点字节与已按 indexType 收窄的索引字节创建（MeshCache 的烘焙数据）
+    // 指针可以直接指向内存映射的文件页；不保留 CPU 数据，也不生成簇、细节级别与位置流
+    Mesh(const void* vertexData, size_t vertexCount, const void* indexData, size_t indexCount, GLenum indexType,
+         std::vector<Texture> textures, VertexFormat format, uint32_t attributes)
+    {
+        this->textures = std::move(textures);
+        this->keepCpuData = false;
+        this->vertexCount = vertexCount;
+        this->vertexFormat = format;
+        this->attributeMask = attributes;
+        this->indexType = indexType;
+
+        setupPacked(vertexData, indexData, indexCount);
+    }
+
     // 拷贝构造函数（禁用）
     Mesh(const Mesh&) = delete;
     // 拷贝赋值运算符（禁用）
@@ -47,14 +143,40 @@ struct Mesh {
         : vertices(std::move(other.vertices))
         , indices(std::move(other.indices))
         , textures(std::move(other.textures))
+        , keepCpuData(other.keepCpuData)
+        , vertexCount(other.vertexCount)
         , VAO(other.VAO)
         , VBO(other.VBO)
         , EBO(other.EBO) 
+        , vertexFormat(other.vertexFormat)
+        , attributeMask(other.attributeMask)
+        , layout(other.layout)
+        , vertexBufferSize(other.vertexBufferSize)
+        , indexType(other.indexType)
+        , indexBufferSize(other.indexBufferSize)
+        , dynamicVertices(other.dynamicVertices)
+        , streamingVertices(std::move(other.streamingVertices))
+        , useArena(other.useArena)
+        , arenaHandle(other.arenaHandle)
+        , buildMeshlets(other.buildMeshlets)
+        , meshlets(std::move(other.meshlets))
+        , drawCounts(std::move(other.drawCounts))
+        , drawOffsets(std::move(other.drawOffsets))
+        , drawBaseVertices(std::move(other.drawBaseVertices))
+        , buildLods(other.buildLods)
+        , lods(std::move(other.lods))
+        , boundsCenter(other.boundsCenter)
+        , boundsRadius(other.boundsRadius)
+        , keepPositionStream(other.keepPositionStream)
+        , positionStream(std::move(other.positionStream))
+        , samplerProgram(other.samplerProgram)
+        , samplerUnits(std::move(other.samplerUnits))
     {
         // 将原对象中的OpenGL对象ID置零，这样原对象析构时就不会删除这些资源
         other.VAO = 0;
         other.VBO = 0;
         other.EBO = 0;
+        other.arenaHandle = GeometryArena::INVALID_HANDLE;
     }
     
     // 移动赋值运算符
@@ -64,12 +186,38 @@ struct Mesh {
             vertices = std::move(other.vertices);
             indices = std::move(other.indices);
             textures = std::move(other.textures);
+            keepCpuData = other.keepCpuData;
+            vertexCount = other.vertexCount;
             VAO = other.VAO;
             VBO = other.VBO;
             EBO = other.EBO;
+            vertexFormat = other.vertexFormat;
+            attributeMask = other.attributeMask;
+            layout = other.layout;
+            vertexBufferSize = other.vertexBufferSize;
+            indexType = other.indexType;
+            indexBufferSize = other.indexBufferSize;
+            dynamicVertices = other.dynamicVertices;
+            streamingVertices = std::move(other.streamingVertices);
+            useArena = other.useArena;
+            arenaHandle = other.arenaHandle;
+            buildMeshlets = other.buildMeshlets;
+            meshlets = std::move(other.meshlets);
+            drawCounts = std::move(other.drawCounts);
+            drawOffsets = std::move(other.drawOffsets);
+            drawBaseVertices = std::move(other.drawBaseVertices);
+            buildLods = other.buildLods;
+            lods = std::move(other.lods);
+            boundsCenter = other.boundsCenter;
+            boundsRadius = other.boundsRadius;
+            keepPositionStream = other.keepPositionStream;
+            positionStream = std::move(other.positionStream);
+            samplerProgram = other.samplerProgram;
+            samplerUnits = std::move(other.samplerUnits);
             other.VAO = 0;
             other.VBO = 0;
             other.EBO = 0;
+            other.arenaHandle = GeometryArena::INVALID_HANDLE;
         }
         return *this;
     }
@@ -80,18 +228,30 @@ struct Mesh {
 
     // 清理OpenGL资源
     void cleanup() {
+        GLStateCache& state = GLStateCache::instance();
         if (EBO) {
             glDeleteBuffers(1, &EBO);
+            state.bufferDeleted(EBO);
             EBO = 0;
         }
         if (VBO) {
             glDeleteBuffers(1, &VBO);
+            state.bufferDeleted(VBO);
             VBO = 0;
         }
+        streamingVertices.destroy();
         if (VAO) {
             glDeleteVertexArrays(1, &VAO);
+            state.vertexArrayDeleted(VAO);
             VAO = 0;
         }
+        if (arenaHandle != GeometryArena::INVALID_HANDLE) {
+            GeometryArena::instance().free(arenaHandle);
+            arenaHandle = GeometryArena::INVALID_HANDLE;
+        }
+        vertexBufferSize = 0;
+        indexBufferSize = 0;
+        positionStream.cleanup();
     }
     
     // 初始化 OpenGL 缓冲区
@@ -100,70 +260,87 @@ struct Mesh {
         cleanup();
         
         if (vertices.empty() || indices.empty()) {
+            if (vertexCount > 0) {
+                std::cout << "ERROR::MESH:: CPU data has been released after upload, set MeshOptions::cpuAccess to re-upload" << std::endl;
+            }
             return false;
         }
+        vertexCount = vertices.size();
         
-        // 1. 创建并绑定 VAO
+        GLStateCache& state = GLStateCache::instance();
+
+        // 簇只引用索引区间，与上传方式无关
+        if (buildMeshlets) {
+            meshlets = Meshlet::build(vertices, indices);
+        }
+
+        // 包围球与细节级别：各级简化索引拼接在原索引之后一起上传
+        computeBounds();
+        std::vector<unsigned int> lodIndices;
+        if (buildLods) {
+            lods = MeshSimplifier::buildChain(vertices, indices, lodIndices);
+        }
+        else {
+            lods.assign(1, LodLevel());
+            lods[0].indexCount = (unsigned int)indices.size();
+        }
+        std::vector<unsigned int> uploadIndices;
+        if (!lodIndices.empty()) {
+            uploadIndices.reserve(indices.size() + lodIndices.size());
+            uploadIndices.insert(uploadIndices.end(), indices.begin(), indices.end());
+            uploadIndices.insert(uploadIndices.end(), lodIndices.begin(), lodIndices.end());
+        }
+        const std::vector<unsigned int>& allIndices = lodIndices.empty() ? indices : uploadIndices;
+
+        // 1. 按顶点布局只打包网格拥有的属性
+        layout = VertexLayout::create(attributeMask, vertexFormat);
+        std::vector<unsigned char> vertexData;
+        if (!layout.pack(vertices, vertexData)) {
+            // 骨骼索引超出 UINT8 范围，回退为完整格式
+            std::cout << "WARNING::MESH:: bone index exceeds 255, fallback to full vertex format" << std::endl;
+            vertexFormat = VertexFormat::FULL;
+            layout = VertexLayout::create(attributeMask, vertexFormat);
+            layout.pack(vertices, vertexData);
+        }
+        vertexBufferSize = vertexData.size();
+
+        // 共享缓冲池：只记录区间，VAO 由同布局的所有网格共用（动态顶点需要独立缓冲，不进入缓冲池）
+        if (useArena && !dynamicVertices) {
+            GeometryArena& arena = GeometryArena::instance();
+            arenaHandle = arena.allocate(layout, vertexData, vertices.size(), allIndices, &indexBufferSize);
+            indexType = arena.range(arenaHandle).indexType;
+            if (keepPositionStream) {
+                positionStream.build(vertices, indices, 0, indexType);
+            }
+            if (!keepCpuData) {
+                releaseCpuData();
+            }
+            return true;
+        }
+
+        // 2. 创建并绑定 VAO 与 VBO
         glGenVertexArrays(1, &VAO);
-        glBindVertexArray(VAO);
-        
-        // 2. 创建并绑定 VBO
-        glGenBuffers(1, &VBO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, 
-                     vertices.size() * sizeof(Vertex),
-                     vertices.data(),
-                     GL_STATIC_DRAW);
+        state.bindVertexArray(VAO);
+
+        if (dynamicVertices) {
+            streamingVertices.init(vertexBufferSize, vertexData.data(), layout.stride);
+        }
+        else {
+            glGenBuffers(1, &VBO);
+            state.bindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, 
+                         vertexBufferSize,
+                         vertexData.data(),
+                         GL_STATIC_DRAW);
+        }
         
-        // 3. 创建并绑定 EBO
+        // 3. 创建并绑定 EBO，索引宽度按顶点数选择
         glGenBuffers(1, &EBO);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        indexType = IndexFormat::upload(allIndices, vertices.size(), &indexBufferSize);
         
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                     indices.size() * sizeof(unsigned int),
-                     indices.data(),
-                     GL_STATIC_DRAW);
-        
-        // 4. 设置顶点属性指针
-        // 位置属性 (location = 0)
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                             (void*)Vertex::positionOffset());
-        glEnableVertexAttribArray(0);
-        
-        // 法线属性 (location = 1)
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                             (void*)Vertex::normalOffset());
-        glEnableVertexAttribArray(1);
-        
-        // 纹理坐标属性 (location = 2)
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                             (void*)Vertex::texCoordOffset());
-        glEnableVertexAttribArray(2);
-
-        // 颜色属性 (location = 3)
-        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                             (void*)Vertex::colorOffset());
-        glEnableVertexAttribArray(3);
-
-        // 切线属性 (location = 4)
-        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                             (void*)Vertex::tangentOffset());
-        glEnableVertexAttribArray(4);
-
-        // 副切线属性 (location = 5)
-        glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                             (void*)Vertex::bitangentOffset());
-        glEnableVertexAttribArray(5);
-
-        // ids
-		glVertexAttribIPointer(6, 4, GL_INT, sizeof(Vertex), 
-                             (void*)Vertex::m_BoneIDsOffset());
-        glEnableVertexAttribArray(6);
-
-		// weights
-		glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), 
-                             (void*)Vertex::m_WeightsOffset());
-        glEnableVertexAttribArray(7);
+        // 4. 由布局设置顶点属性指针，未拥有的属性保持禁用
+        layout.apply();
 
         GLenum err = glGetError();
         if (err != GL_NO_ERROR) {
@@ -172,73 +349,190 @@ struct Mesh {
         } 
 
         // 5. 解绑 VAO
-        glBindVertexArray(0);
+        state.bindVertexArray(0);
+
+        // 6. 深度通道的位置流
+        if (keepPositionStream) {
+            positionStream.build(vertices, indices, EBO, indexType);
+        }
+
+        // 7. 驻留策略：不需要 CPU 访问时释放主机内存
+        if (!keepCpuData) {
+            releaseCpuData();
+        }
 
         return true;
     }
+
+    // 上传预先打包的数据：字节已与布局、索引宽度一致，直接 glBufferData，不再经过 Vertex 打包与索引收窄
+    bool setupPacked(const void* vertexData, const void* indexData, size_t indexCount) {
+        cleanup();
+        if (vertexCount == 0 || indexCount == 0) {
+            return false;
+        }
+
+        layout = VertexLayout::create(attributeMask, vertexFormat);
+        vertexBufferSize = vertexCount * layout.stride;
+        indexBufferSize = indexCount * IndexFormat::typeSize(indexType);
+        lods.assign(1, LodLevel());
+        lods[0].indexCount = (unsigned int)indexCount;
+
+        GLStateCache& state = GLStateCache::instance();
+        glGenVertexArrays(1, &VAO);
+        state.bindVertexArray(VAO);
+
+        glGenBuffers(1, &VBO);
+        state.bindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertexBufferSize, vertexData, GL_STATIC_DRAW);
+
+        glGenBuffers(1, &EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBufferSize, indexData, GL_STATIC_DRAW);
+
+        layout.apply();
+
+        GLenum err = glGetError();
+        if (err != GL_NO_ERROR) {
+            std::cerr << "OpenGL error binding VAO: " << err << std::endl;
+            return false;
+        }
+        state.bindVertexArray(0);
+        return true;
+    }
+
+    // 读回实际上传的顶点与索引字节（只含 lods[0]，即原网格的索引），用于烘焙缓存
+    // 位于 GeometryArena 或使用流式顶点缓冲时没有独立的 VBO，返回 false
+    bool readBack(std::vector<unsigned char>& vertexData, std::vector<unsigned char>& indexData) const {
+        if (VAO == 0 || VBO == 0 || EBO == 0) {
+            return false;
+        }
+        GLStateCache& state = GLStateCache::instance();
+        vertexData.resize(vertexBufferSize);
+        state.bindBuffer(GL_ARRAY_BUFFER, VBO);
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, vertexBufferSize, vertexData.data());
+
+        // EBO 是 VAO 状态的一部分，绑定 VAO 即绑定了它
+        indexData.resize((size_t)indexCount() * IndexFormat::typeSize(indexType));
+        state.bindVertexArray(VAO);
+        glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexData.size(), indexData.data());
+        state.bindVertexArray(0);
+        return glGetError() == GL_NO_ERROR;
+    }
+
+    // 原地更新顶点内容（顶点数与索引不变，例如几何体尺寸改变）：复用现有的 VAO/VBO/EBO，不重新创建
+    // 动态顶点写入流式缓冲的下一段；否则先 glBufferData(NULL) 孤立旧存储，再 glBufferSubData，不等待 GPU 读完旧数据
+    // 顶点数改变、尚未上传、位于 GeometryArena，或带有依赖顶点位置的簇与细节级别时退回 setupBuffers()
+    bool updateVertices() {
+        if (vertices.empty() || indices.empty() || VAO == 0 || vertices.size() != vertexCount
+            || buildMeshlets || buildLods) {
+            return setupBuffers();
+        }
+
+        std::vector<unsigned char> vertexData;
+        if (!layout.pack(vertices, vertexData) || vertexData.size() != vertexBufferSize) {
+            return setupBuffers();
+        }
+        computeBounds();
+
+        if (streamingVertices.valid()) {
+            if (!streamingVertices.update(vertexData.data(), (GLsizeiptr)vertexData.size())) {
+                return setupBuffers();
+            }
+        }
+        else {
+            GLStateCache::instance().bindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, vertexBufferSize, NULL, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, vertexBufferSize, vertexData.data());
+        }
+
+        // 位置流是独立的紧凑副本，需要一起更新；合并关系不变时原地更新，否则重新生成
+        if (keepPositionStream && !positionStream.update(vertices)) {
+            positionStream.build(vertices, indices, EBO, indexType);
+        }
+        if (!keepCpuData) {
+            releaseCpuData();
+        }
+        return true;
+    }
+
+    // 动态顶点当前段的顶点偏移，静态缓冲为 0
+    GLint streamBaseVertex() const {
+        return streamingVertices.valid() ? streamingVertices.baseVertex() : 0;
+    }
+
+    // 释放 CPU 端的顶点与索引（swap 到空容器，真正归还内存）
+    void releaseCpuData() {
+        std::vector<Vertex>().swap(vertices);
+        std::vector<unsigned int>().swap(indices);
+    }
     
+    // 每顶点字节数（顶点拉取时实际读取的大小）
+    size_t vertexStride() const {
+        return layout.stride;
+    }
+
+    // 某一级细节的索引数
+    GLsizei indexCount(int level = 0) const {
+        return lods.empty() ? (GLsizei)indices.size() : (GLsizei)lods[level].indexCount;
+    }
+
     // 渲染网格
-    bool render(Shader shader) const {
-        if (VAO == 0) {
+    bool render(const Shader& shader) const {
+        return renderLod(shader, 0);
+    }
+
+    // 以第 level 级细节渲染网格
+    bool renderLod(const Shader& shader, int level) const {
+        if (lods.empty()) {
+            level = 0;
+        }
+        else {
+            level = std::min(std::max(level, 0), (int)lods.size() - 1);
+        }
+        GLuint firstIndex = lods.empty() ? 0 : lods[level].firstIndex;
+
+        if (VAO == 0 && arenaHandle == GeometryArena::INVALID_HANDLE) {
             std::cerr << "VAO not initialized!" << std::endl;
             return false;
         }
         
-        // 检查是否有顶点数据
-        if (vertices.empty() || indices.empty()) {
+        // 检查是否有顶点数据（CPU 数据可能已在上传后释放，这里只看上传的数量）
+        if (vertexCount == 0 || indexCount(level) == 0) {
             std::cerr << "No data to render!" << std::endl;
             return false;
         }
 
-        
+        GLStateCache& state = GLStateCache::instance();
         shader.use();
+        bindTextures(shader);
 
-        // 检查当前OpenGL上下文
-        if (glGetString(GL_VERSION) == nullptr) {
-            std::cerr << "No valid OpenGL context!" << std::endl;
-            return false;
-        }
-
-        // 四个独立的纹理计数器
-        unsigned int cnt_diffuse    = 1;
-        unsigned int cnt_specular   = 1;
-        unsigned int cnt_normal     = 1;
-        unsigned int cnt_height     = 1;
-        unsigned int cnt_reflection = 1;
-        
-        for (int i = 0; i < textures.size(); i++) {
-            glActiveTexture(GL_TEXTURE0 + i);
-
-            std::string number;
-            std::string name = textures[i].type;
-            if(name == "texture_diffuse") 
-                number = std::to_string(cnt_diffuse++);
-            else if(name == "texture_specular")
-                number = std::to_string(cnt_specular++); 
-            else if(name == "texture_normal")
-                number = std::to_string(cnt_normal++); 
-            else if(name == "texture_height")
-                number = std::to_string(cnt_height++); 
-            else if(name == "texture_reflection");
-                number = std::to_string(cnt_reflection++);
-
-            std::string uniformName = textures[i].type + number;
-
-            shader.setInt(uniformName.c_str(), i);
-            glBindTexture(GL_TEXTURE_2D, textures[i].id);
+        if (arenaHandle != GeometryArena::INVALID_HANDLE) {
+            GeometryArena::instance().draw(arenaHandle, indexCount(level), firstIndex);
+            return true;
         }
 
-        glBindVertexArray(VAO);
+        // 连续绘制同一 VAO 时不再重复绑定，也不再每次解绑
+        state.bindVertexArray(VAO);
         // GLenum err = glGetError();
         // if (err != GL_NO_ERROR) {
         //     std::cerr << "OpenGL error binding VAO: " << err << std::endl;
         //     return false;
         // } 
         
-        glDrawElements(GL_TRIANGLES, 
-                    indices.size(),
-                    GL_UNSIGNED_INT, 
-                    0);
+        GLint baseVertex = streamBaseVertex();
+        if (baseVertex != 0) {
+            glDrawElementsBaseVertex(GL_TRIANGLES, 
+                                     indexCount(level),
+                                     indexType, 
+                                     (void*)(firstIndex * IndexFormat::typeSize(indexType)),
+                                     baseVertex);
+        }
+        else {
+            glDrawElements(GL_TRIANGLES, 
+                        indexCount(level),
+                        indexType, 
+                        (void*)(firstIndex * IndexFormat::typeSize(indexType)));
+        }
         
         // err = glGetError();
         // if (err != GL_NO_ERROR) {
@@ -246,18 +540,156 @@ struct Mesh {
         //     return false;
         // }
 
-        glBindVertexArray(0);
-
-        // 恢复默认材质
-        glActiveTexture(GL_TEXTURE0);
-        
         return true;
     }
     
+    // 簇级剔除后绘制：可见簇的相邻索引区间合并，整个网格一次 glMultiDrawElements(BaseVertex)
+    // 没有簇时退化为 render()
+    bool renderCulled(const Shader& shader, const MeshletCuller& culler) const {
+        if (meshlets.empty()) {
+            return render(shader);
+        }
+
+        size_t indexSize = IndexFormat::typeSize(indexType);
+        size_t indexBase = 0;
+        GLint baseVertex = streamBaseVertex();
+        GLuint vertexArray = VAO;
+        bool inArena = arenaHandle != GeometryArena::INVALID_HANDLE;
+        if (inArena) {
+            const GeometryArena::Range& range = GeometryArena::instance().range(arenaHandle);
+            indexBase = range.indexOffset;
+            baseVertex = range.baseVertex;
+            vertexArray = GeometryArena::instance().vertexArray(arenaHandle);
+        }
+        if (vertexArray == 0) {
+            return false;
+        }
+
+        drawCounts.clear();
+        drawOffsets.clear();
+        size_t nextIndex = ~(size_t)0;
+        for (const Meshlet& meshlet : meshlets) {
+            if (!culler.visible(meshlet))
+                continue;
+            GLsizei count = (GLsizei)(meshlet.triangleCount * 3);
+            if (meshlet.firstIndex == nextIndex) {
+                drawCounts.back() += count;
+            }
+            else {
+                drawCounts.push_back(count);
+                drawOffsets.push_back((const void*)(indexBase + meshlet.firstIndex * indexSize));
+            }
+            nextIndex = meshlet.firstIndex + count;
+        }
+        if (drawCounts.empty()) {
+            return true;
+        }
+
+        shader.use();
+        bindTextures(shader);
+        GLStateCache::instance().bindVertexArray(vertexArray);
+        if (inArena || baseVertex != 0) {
+            drawBaseVertices.assign(drawCounts.size(), baseVertex);
+            glMultiDrawElementsBaseVertex(GL_TRIANGLES, drawCounts.data(), indexType,
+                                          const_cast<void* const*>(drawOffsets.data()), (GLsizei)drawCounts.size(), drawBaseVertices.data());
+        }
+        else {
+            glMultiDrawElements(GL_TRIANGLES, drawCounts.data(), indexType, drawOffsets.data(), (GLsizei)drawCounts.size());
+        }
+        return true;
+    }
+
+    // 深度/阴影通道：只写深度，不绑定纹理；调用前需激活深度着色器
+    // 有位置流时每个顶点只拉取 12 字节，否则回退到完整的着色 VAO
+    bool renderDepth() const {
+        if (positionStream.valid()) {
+            positionStream.render();
+            return true;
+        }
+        if (arenaHandle != GeometryArena::INVALID_HANDLE) {
+            GeometryArena::instance().draw(arenaHandle, indexCount());
+            return true;
+        }
+        if (VAO == 0) {
+            return false;
+        }
+        GLStateCache::instance().bindVertexArray(VAO);
+        glDrawElementsBaseVertex(GL_TRIANGLES, indexCount(), indexType, 0, streamBaseVertex());
+        return true;
+    }
+
+    // 绑定网格的纹理，采样器的纹理单元在链接时已自动分配，每个程序只解析一次
+    void bindTextures(const Shader& shader) const {
+        if (samplerProgram != shader.ID || samplerUnits.size() != textures.size()) {
+            resolveSamplerUnits(shader);
+        }
+        GLStateCache& state = GLStateCache::instance();
+        for (size_t i = 0; i < textures.size(); i++) {
+            if (samplerUnits[i] >= 0) {
+                state.bindTexture(samplerUnits[i], GL_TEXTURE_2D, textures[i].id);
+            }
+        }
+    }
+
+    // 按 texture_diffuseN / texture_specularN ... 的命名约定查找每张纹理对应的纹理单元
+    // 着色器中不存在的采样器记为 -1，渲染时跳过
+    void resolveSamplerUnits(const Shader& shader) const {
+        unsigned int cnt_diffuse    = 1;
+        unsigned int cnt_specular   = 1;
+        unsigned int cnt_normal     = 1;
+        unsigned int cnt_height     = 1;
+        unsigned int cnt_reflection = 1;
+
+        samplerUnits.resize(textures.size());
+        for (size_t i = 0; i < textures.size(); i++) {
+            unsigned int number = 1;
+            const std::string& name = textures[i].type;
+            if(name == "texture_diffuse") 
+                number = cnt_diffuse++;
+            else if(name == "texture_specular")
+                number = cnt_specular++; 
+            else if(name == "texture_normal")
+                number = cnt_normal++; 
+            else if(name == "texture_height")
+                number = cnt_height++; 
+            else if(name == "texture_reflection")
+                number = cnt_reflection++;
+
+            char uniformName[64];
+            std::snprintf(uniformName, sizeof(uniformName), "%s%u", name.c_str(), number);
+            samplerUnits[i] = shader.samplerUnit(uniformName);
+        }
+        samplerProgram = shader.ID;
+    }
+
+    // 包围球：AABB 中心与最远顶点距离
+    void computeBounds() {
+        if (vertices.empty()) {
+            boundsCenter = glm::vec3(0.0f);
+            boundsRadius = 0.0f;
+            return;
+        }
+        glm::vec3 minimum = vertices[0].position;
+        glm::vec3 maximum = vertices[0].position;
+        for (const Vertex& vertex : vertices) {
+            minimum = glm::min(minimum, vertex.position);
+            maximum = glm::max(maximum, vertex.position);
+        }
+        boundsCenter = (minimum + maximum) * 0.5f;
+        float radiusSquared = 0.0f;
+        for (const Vertex& vertex : vertices) {
+            glm::vec3 offset = vertex.position - boundsCenter;
+            radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+        }
+        boundsRadius = std::sqrt(radiusSquared);
+    }
+
     // 清空网格数据
     void clear() {
         vertices.clear();
         indices.clear();
+        meshlets.clear();
+        lods.clear();
         cleanup();
     }
 };
@@ -0,0 +1,548 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include "Mesh.h"
+#include "MappedFile.h"
+#include "Animation/Skeleton.h"
+#include "Animation/AnimationClipStore.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 烘焙网格缓存：把 Model 导入的最终结果写入缓存目录，下次加载时映射该文件，不再运行 assimp
+// 缓存内容：焊接、重排、生成切线并按 VertexLayout 打包后的顶点字节，收窄后的索引字节，纹理引用，骨架节点与重采样的动画
+// 顶点与索引按 16 字节对齐存放，加载时 glBufferData 直接从映射的文件页读取
+// 每个 (模型路径, 导入选项) 一个缓存文件，文件名为两者的 FNV-1a 哈希，不同选项的缓存互不覆盖
+// 文件头记录完整的模型路径、源文件的大小、修改时间与内容哈希以及导入选项，不一致时缓存失效
+// 源文件引用的 .mtl 与纹理不参与校验；默认关闭，调用 setDirectory() 设置缓存目录后启用
+class MeshCache
+{
+public:
+    struct CookedMesh {
+        uint32_t attributeMask = 0;
+        VertexFormat vertexFormat = VertexFormat::FULL;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        GLenum indexType = GL_UNSIGNED_INT;
+        glm::vec3 boundsCenter = glm::vec3(0.0f);
+        float boundsRadius = 0.0f;
+        const unsigned char* vertexData = nullptr;      // 指向映射的文件页
+        const unsigned char* indexData = nullptr;
+        std::vector<uint32_t> textures;                 // CookedModel::textures 中的下标
+    };
+
+    // 加载结果：网格数据指向 file 的映射，file 关闭前必须完成上传
+    struct CookedModel {
+        MappedFile file;
+        std::vector<Texture> textures;          // 只有 type 与 path，纹理由调用方加载
+        std::vector<CookedMesh> meshes;
+        Skeleton skeleton;
+        std::vector<AnimationClip> clips;       // 重采样的原始帧，是否压缩由调用方决定
+        uint64_t sourceKeys = 0;                // 源文件中的动画关键帧数
+        double assimpMilliseconds = 0.0;        // 烘焙时 assimp 路径的加载耗时
+        float residentFraction = -1.0f;         // 映射前缓存文件已在页缓存中的比例
+    };
+
+    static MeshCache& instance()
+    {
+        static MeshCache cache;
+        return cache;
+    }
+
+    // 设置缓存目录并启用缓存；传入空字符串则关闭
+    void setDirectory(const std::string& directory)
+    {
+        directory_ = directory;
+        if (!directory_.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(directory_, ec);
+        }
+    }
+
+    bool enabled() const
+    {
+        return !directory_.empty();
+    }
+
+    // 缓存中只有最终的 GPU 字节，需要 CPU 顶点的选项（共享缓冲池、动态顶点、簇、细节级别、位置流、保留 CPU 数据）不使用缓存
+    static bool supports(const MeshOptions& options)
+    {
+        return !options.useArena && !options.dynamicVertices && !options.meshlets && !options.lodChain
+            && !options.positionStream && !options.cpuAccess;
+    }
+
+    // 影响烘焙结果的导入选项
+    static uint64_t makeKey(const MeshOptions& options)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        uint32_t format = (uint32_t)options.vertexFormat;
+        uint64_t maxVertices = options.maxVerticesPerMesh;
+        hash = hashBytes(hash, &format, sizeof(format));
+        hash = hashBytes(hash, &options.splitLargeMeshes, sizeof(bool));
+        hash = hashBytes(hash, &maxVertices, sizeof(maxVertices));
+        hash = hashBytes(hash, &options.weldVertices, sizeof(bool));
+        hash = hashBytes(hash, &options.weldEpsilon, sizeof(float));
+        hash = hashBytes(hash, &options.optimizeVertexCache, sizeof(bool));
+        return hash;
+    }
+
+    // 映射并校验 sourcePath 的缓存文件，成功时 model 中的网格指向映射的页
+    // 文件损坏、版本不一致、源文件已改变时删除缓存文件并返回 false；其他导入选项的缓存在各自的文件中，不受影响
+    bool load(const std::string& sourcePath, uint64_t key, CookedModel& model)
+    {
+        if (!enabled() || !model.file.open(filePath(sourcePath, key)))
+            return false;
+        model.residentFraction = model.file.residentFraction();
+        if (parse(sourcePath, key, model))
+            return true;
+
+        model.file.close();
+        model.textures.clear();
+        model.meshes.clear();
+        model.skeleton = Skeleton();
+        model.clips.clear();
+        invalidate(sourcePath, key);
+        return false;
+    }
+
+    // 烘焙：读回网格实际上传的字节并连同纹理引用、骨架与动画写入缓存
+    // animations 中的片段必须仍保留重采样的原始帧（在压缩之前调用）
+    bool store(const std::string& sourcePath, uint64_t key, const std::vector<Mesh>& meshes, const Skeleton& skeleton,
+               const AnimationClipStore& animations, uint64_t sourceKeys, double assimpMilliseconds)
+    {
+        if (!enabled())
+            return false;
+        auto start = std::chrono::high_resolution_clock::now();
+
+        Header header;
+        header.key = key;
+        header.assimpMilliseconds = assimpMilliseconds;
+        header.sourceKeys = sourceKeys;
+        if (!sourceStamp(sourcePath, header.sourceSize, header.sourceTime) || !hashFile(sourcePath, header.sourceHash))
+            return false;
+
+        // 纹理引用表：同一张纹理被多个网格引用时只存一次
+        std::vector<const Texture*> textures;
+        std::vector<std::vector<uint32_t>> meshTextures(meshes.size());
+        for (size_t m = 0; m < meshes.size(); m++) {
+            for (const Texture& texture : meshes[m].textures) {
+                size_t index = 0;
+                while (index < textures.size() && (textures[index]->path != texture.path || textures[index]->type != texture.type))
+                    index++;
+                if (index == textures.size())
+                    textures.push_back(&texture);
+                meshTextures[m].push_back((uint32_t)index);
+            }
+        }
+
+        Writer writer;
+        writer.write(header);
+        writer.writeString(sourcePath);
+        for (const Texture* texture : textures) {
+            writer.writeString(texture->type);
+            writer.writeString(texture->path);
+        }
+
+        std::vector<unsigned char> vertexData;
+        std::vector<unsigned char> indexData;
+        for (size_t m = 0; m < meshes.size(); m++) {
+            const Mesh& mesh = meshes[m];
+            if (!mesh.readBack(vertexData, indexData)) {
+                std::cout << "ERROR::MESH_CACHE::READ_BACK_FAILED: " << sourcePath << " mesh " << m << std::endl;
+                return false;
+            }
+            MeshRecord record;
+            record.attributeMask = mesh.attributeMask;
+            record.vertexFormat = (uint32_t)mesh.vertexFormat;
+            record.vertexCount = (uint32_t)mesh.vertexCount;
+            record.indexCount = (uint32_t)mesh.indexCount();
+            record.indexType = mesh.indexType;
+            record.textureCount = (uint32_t)meshTextures[m].size();
+            std::memcpy(record.boundsCenter, &mesh.boundsCenter[0], sizeof(record.boundsCenter));
+            record.boundsRadius = mesh.boundsRadius;
+            writer.write(record);
+            writer.write(meshTextures[m].data(), meshTextures[m].size() * sizeof(uint32_t));
+            writer.align(DATA_ALIGNMENT);
+            writer.write(vertexData.data(), vertexData.size());
+            writer.align(DATA_ALIGNMENT);
+            writer.write(indexData.data(), indexData.size());
+        }
+
+        // 骨架：先写骨骼再写节点，加载时按导入时的顺序 addBone / addNode 重建
+        // 层级中找不到节点的骨骼在加载时被视为损坏，这样的模型不烘焙，每次都走 assimp
+        for (int node : skeleton.boneNodes) {
+            if (node < 0) {
+                std::cout << "MESH_CACHE::SKIPPED " << sourcePath << " bone without a node in the hierarchy" << std::endl;
+                return false;
+            }
+        }
+        std::vector<std::string> boneNames(skeleton.boneCount());
+        for (const auto& bone : skeleton.boneIndex)
+            boneNames[bone.second] = bone.first;
+        for (size_t b = 0; b < skeleton.boneCount(); b++) {
+            writer.writeString(boneNames[b]);
+            writer.write(&skeleton.boneOffsets[b][0][0], 16 * sizeof(float));
+        }
+        for (const Skeleton::Node& node : skeleton.nodes) {
+            int32_t parent = node.parent;
+            writer.writeString(node.name);
+            writer.write(parent);
+            writer.write(&node.bindLocal[0][0], 16 * sizeof(float));
+        }
+        writer.write(&skeleton.globalInverse[0][0], 16 * sizeof(float));
+
+        for (size_t c = 0; c < animations.size(); c++) {
+            const AnimationClip& clip = animations[c];
+            ClipRecord record;
+            record.duration = clip.duration;
+            record.sampleRate = clip.sampleRate;
+            record.frameCount = clip.frameCount;
+            record.channelCount = clip.channelCount;
+            record.stride = clip.stride;
+            record.sampleCount = clip.samples.size();
+            writer.writeString(clip.name);
+            writer.write(record);
+            writer.align(DATA_ALIGNMENT);
+            writer.write(clip.samples.data(), clip.samples.size() * sizeof(float));
+        }
+
+        header.textureCount = (uint32_t)textures.size();
+        header.meshCount = (uint32_t)meshes.size();
+        header.boneCount = (uint32_t)skeleton.boneCount();
+        header.nodeCount = (uint32_t)skeleton.nodeCount();
+        header.clipCount = (uint32_t)animations.size();
+        header.fileSize = writer.bytes.size();
+        std::memcpy(writer.bytes.data(), &header, sizeof(header));
+
+        // 先写临时文件再改名，其他进程不会映射到写了一半的文件
+        std::string path = filePath(sourcePath, key);
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                std::cout << "ERROR::MESH_CACHE::FILE_NOT_WRITABLE: " << temporary << std::endl;
+                return false;
+            }
+            file.write(reinterpret_cast<const char*>(writer.bytes.data()), (std::streamsize)writer.bytes.size());
+            if (!file) {
+                std::cout << "ERROR::MESH_CACHE::FILE_NOT_WRITABLE: " << temporary << std::endl;
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(temporary, path, ec);
+        if (ec) {
+            std::filesystem::remove(temporary, ec);
+            return false;
+        }
+
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        std::cout << "MESH_CACHE::COOKED " << sourcePath << " -> " << path
+                  << " " << writer.bytes.size() / (1024.0f * 1024.0f) << " MB in " << milliseconds << " ms" << std::endl;
+        return true;
+    }
+
+    // 记录并输出单个模型的加载情况：命中时与烘焙时记录的 assimp 耗时比较，并按映射前的页驻留比例区分冷/热加载
+    void report(const std::string& label, bool hit, double milliseconds, double assimpMilliseconds = 0.0, float residentFraction = -1.0f)
+    {
+        if (!hit) {
+            misses_++;
+            std::cout << "MESH_CACHE::MISS " << label << " assimp: " << milliseconds << " ms" << std::endl;
+            return;
+        }
+        hits_++;
+        std::cout << "MESH_CACHE::HIT  " << label << " " << milliseconds << " ms";
+        if (residentFraction >= 0.0f)
+            std::cout << " (" << (residentFraction >= 0.99f ? "warm" : "cold") << ", " << 100.0f * residentFraction << "% pages resident)";
+        if (assimpMilliseconds > 0.0 && milliseconds > 0.0)
+            std::cout << ", assimp: " << assimpMilliseconds << " ms (" << assimpMilliseconds / milliseconds << "x)";
+        std::cout << std::endl;
+    }
+
+    void printStats() const
+    {
+        std::cout << "MESH_CACHE:: hits: " << hits_ << ", misses: " << misses_ << std::endl;
+    }
+
+private:
+    struct Header {
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint64_t key = 0;                   // 导入选项
+        uint64_t sourceHash = 0;            // 源文件内容
+        uint64_t sourceSize = 0;
+        int64_t sourceTime = 0;             // 源文件修改时间
+        uint64_t fileSize = 0;              // 缓存文件大小，检查写入是否被截断
+        double assimpMilliseconds = 0.0;
+        uint64_t sourceKeys = 0;
+        uint32_t textureCount = 0;
+        uint32_t meshCount = 0;
+        uint32_t boneCount = 0;
+        uint32_t nodeCount = 0;
+        uint32_t clipCount = 0;
+        uint32_t reserved = 0;
+    };
+
+    // 之后依次为 textureCount 个纹理下标、对齐的顶点字节、对齐的索引字节
+    struct MeshRecord {
+        uint32_t attributeMask = 0;
+        uint32_t vertexFormat = 0;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        uint32_t indexType = 0;
+        uint32_t textureCount = 0;
+        float boundsCenter[3] = { 0.0f, 0.0f, 0.0f };
+        float boundsRadius = 0.0f;
+    };
+
+    // 之后为对齐的 sampleCount 个 float
+    struct ClipRecord {
+        float duration = 0.0f;
+        float sampleRate = 0.0f;
+        uint32_t frameCount = 0;
+        uint32_t channelCount = 0;
+        uint32_t stride = 0;
+        uint32_t reserved = 0;
+        uint64_t sampleCount = 0;
+    };
+
+    struct Writer {
+        std::vector<unsigned char> bytes;
+
+        void write(const void* data, size_t size)
+        {
+            const unsigned char* begin = static_cast<const unsigned char*>(data);
+            bytes.insert(bytes.end(), begin, begin + size);
+        }
+
+        template <typename T>
+        void write(const T& value) { write(&value, sizeof(T)); }
+
+        void writeString(const std::string& value)
+        {
+            uint32_t length = (uint32_t)value.size();
+            write(length);
+            write(value.data(), value.size());
+        }
+
+        void align(size_t alignment)
+        {
+            bytes.resize((bytes.size() + alignment - 1) / alignment * alignment, 0);
+        }
+    };
+
+    // 所有读取都检查边界，损坏或截断的文件只会导致解析失败
+    struct Reader {
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        size_t offset = 0;
+
+        bool read(void* out, size_t count)
+        {
+            if (count > size - offset)
+                return false;
+            std::memcpy(out, data + offset, count);
+            offset += count;
+            return true;
+        }
+
+        template <typename T>
+        bool read(T& value) { return read(&value, sizeof(T)); }
+
+        bool readString(std::string& value)
+        {
+            uint32_t length = 0;
+            if (!read(length) || length > size - offset)
+                return false;
+            value.assign(reinterpret_cast<const char*>(data + offset), length);
+            offset += length;
+            return true;
+        }
+
+        // 返回对齐后 count 字节的起始位置（不拷贝），越界时返回 nullptr
+        const unsigned char* bytes(size_t count, size_t alignment)
+        {
+            size_t begin = (offset + alignment - 1) / alignment * alignment;
+            if (begin > size || count > size - begin)
+                return nullptr;
+            offset = begin + count;
+            return data + begin;
+        }
+    };
+
+    static constexpr uint32_t MAGIC = 0x434D4C47;   // "GLMC"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t DATA_ALIGNMENT = 16;
+
+    std::string directory_;
+    int hits_ = 0;
+    int misses_ = 0;
+
+    MeshCache() = default;
+
+    bool parse(const std::string& sourcePath, uint64_t key, CookedModel& model) const
+    {
+        Reader reader;
+        reader.data = model.file.data();
+        reader.size = model.file.size();
+
+        Header header;
+        std::string storedPath;
+        if (!reader.read(header) || header.magic != MAGIC || header.version != VERSION || header.key != key
+            || header.fileSize != reader.size || !reader.readString(storedPath) || storedPath != sourcePath
+            || !sourceMatches(sourcePath, header))
+            return false;
+        model.sourceKeys = header.sourceKeys;
+        model.assimpMilliseconds = header.assimpMilliseconds;
+
+        model.textures.resize(header.textureCount);
+        for (Texture& texture : model.textures) {
+            texture.id = 0;
+            if (!reader.readString(texture.type) || !reader.readString(texture.path))
+                return false;
+        }
+
+        model.meshes.resize(header.meshCount);
+        for (CookedMesh& mesh : model.meshes) {
+            MeshRecord record;
+            if (!reader.read(record) || record.vertexFormat > (uint32_t)VertexFormat::PACKED)
+                return false;
+            if (record.indexType != GL_UNSIGNED_BYTE && record.indexType != GL_UNSIGNED_SHORT && record.indexType != GL_UNSIGNED_INT)
+                return false;
+            mesh.textures.resize(record.textureCount);
+            if (!reader.read(mesh.textures.data(), mesh.textures.size() * sizeof(uint32_t)))
+                return false;
+            for (uint32_t texture : mesh.textures)
+                if (texture >= header.textureCount)
+                    return false;
+
+            mesh.attributeMask = record.attributeMask;
+            mesh.vertexFormat = (VertexFormat)record.vertexFormat;
+            mesh.vertexCount = record.vertexCount;
+            mesh.indexCount = record.indexCount;
+            mesh.indexType = record.indexType;
+            mesh.boundsCenter = glm::vec3(record.boundsCenter[0], record.boundsCenter[1], record.boundsCenter[2]);
+            mesh.boundsRadius = record.boundsRadius;
+            size_t stride = (size_t)VertexLayout::create(mesh.attributeMask, mesh.vertexFormat).stride;
+            mesh.vertexData = reader.bytes((size_t)mesh.vertexCount * stride, DATA_ALIGNMENT);
+            mesh.indexData = reader.bytes((size_t)mesh.indexCount * IndexFormat::typeSize(mesh.indexType), DATA_ALIGNMENT);
+            if (mesh.vertexData == nullptr || mesh.indexData == nullptr)
+                return false;
+        }
+
+        for (uint32_t b = 0; b < header.boneCount; b++) {
+            std::string name;
+            glm::mat4 offset;
+            if (!reader.readString(name) || !reader.read(&offset[0][0], 16 * sizeof(float)))
+                return false;
+            model.skeleton.addBone(name, offset);
+        }
+        for (uint32_t n = 0; n < header.nodeCount; n++) {
+            std::string name;
+            int32_t parent = -1;
+            glm::mat4 bindLocal;
+            if (!reader.readString(name) || !reader.read(parent) || !reader.read(&bindLocal[0][0], 16 * sizeof(float)))
+                return false;
+            if (parent < -1 || parent >= (int32_t)n)
+                return false;
+            model.skeleton.addNode(name, parent, bindLocal);
+        }
+        if (!reader.read(&model.skeleton.globalInverse[0][0], 16 * sizeof(float)))
+            return false;
+        // 每根骨骼都必须对应到层级中的节点（store 不烘焙带有孤立骨骼的模型，出现时只能是文件损坏）
+        for (int node : model.skeleton.boneNodes)
+            if (node < 0)
+                return false;
+
+        model.clips.resize(header.clipCount);
+        for (AnimationClip& clip : model.clips) {
+            ClipRecord record;
+            if (!reader.readString(clip.name) || !reader.read(record))
+                return false;
+            if (record.sampleCount != (uint64_t)record.frameCount * AnimationClip::COMPONENT_COUNT * record.stride
+                || record.channelCount != header.nodeCount)
+                return false;
+            // PoseEvaluator 按 stride 以 SoA 方式读取帧：stride 必须补齐到 4 的倍数且容纳所有通道
+            if (record.frameCount == 0 || !(record.sampleRate > 0.0f) || record.stride < record.channelCount || record.stride % 4 != 0)
+                return false;
+            const unsigned char* samples = reader.bytes(record.sampleCount * sizeof(float), DATA_ALIGNMENT);
+            if (samples == nullptr)
+                return false;
+            clip.duration = record.duration;
+            clip.sampleRate = record.sampleRate;
+            clip.frameCount = record.frameCount;
+            clip.channelCount = record.channelCount;
+            clip.stride = record.stride;
+            clip.samples.resize(record.sampleCount);
+            std::memcpy(clip.samples.data(), samples, record.sampleCount * sizeof(float));
+        }
+        return true;
+    }
+
+    // 大小与修改时间都一致时认为源文件没有改变，不再读取整个文件；修改时间不同（例如重新检出）时比较内容哈希
+    static bool sourceMatches(const std::string& sourcePath, const Header& header)
+    {
+        uint64_t size = 0;
+        int64_t time = 0;
+        if (!sourceStamp(sourcePath, size, time) || size != header.sourceSize)
+            return false;
+        if (time == header.sourceTime)
+            return true;
+        uint64_t hash = 0;
+        return hashFile(sourcePath, hash) && hash == header.sourceHash;
+    }
+
+    static bool sourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& time)
+    {
+        std::error_code ec;
+        size = (uint64_t)std::filesystem::file_size(sourcePath, ec);
+        if (ec)
+            return false;
+        time = (int64_t)std::filesystem::last_write_time(sourcePath, ec).time_since_epoch().count();
+        return !ec;
+    }
+
+    static bool hashFile(const std::string& path, uint64_t& hash)
+    {
+        MappedFile file;
+        if (!file.open(path))
+            return false;
+        hash = hashBytes(14695981039346656037ull, file.data(), file.size());
+        return true;
+    }
+
+    static uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // 文件名为模型路径与导入选项的哈希；哈希碰撞时文件头中的路径或选项不一致，按未命中处理
+    std::string filePath(const std::string& sourcePath, uint64_t key) const
+    {
+        uint64_t hash = hashBytes(14695981039346656037ull, sourcePath.data(), sourcePath.size());
+        hash = hashBytes(hash, &key, sizeof(key));
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.mesh", (unsigned long long)hash);
+        return (std::filesystem::path(directory_) / name).string();
+    }
+
+    void invalidate(const std::string& sourcePath, uint64_t key) const
+    {
+        std::error_code ec;
+        std::filesystem::remove(filePath(sourcePath, key), ec);
+    }
+};
+
+#endif
@@ -0,0 +1,310 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <glm/glm.hpp>
+
+#include "Vertex.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 顶点缓存统计
+// ACMR（average cache miss ratio）：每个三角形的平均缓存未命中数，即顶点着色器调用次数 / 三角形数，最优约为 0.5
+// ATVR（average transformed vertex ratio）：顶点着色器调用次数 / 唯一顶点数，最优为 1.0
+struct VertexCacheStats {
+    size_t triangles = 0;
+    size_t vertices = 0;
+    size_t misses = 0;
+
+    float acmr() const { return triangles ? (float)misses / triangles : 0.0f; }
+    float atvr() const { return vertices ? (float)misses / vertices : 0.0f; }
+};
+
+// 导入与程序生成时的网格优化
+// 1. Tipsify（Sander et al. 2007）按后变换缓存重排三角形
+// 2. 以 Tipsify 的簇为单位按朝外程度重排，先画朝外的簇以减少过度绘制，同时保证 ACMR 不超过阈值
+// 3. 按首次使用顺序重新编号顶点，使顶点拉取尽量顺序访问，并去掉未被引用的顶点
+class MeshOptimizer
+{
+public:
+    static const unsigned int CACHE_SIZE = 16;   // 模拟的 FIFO 后变换缓存大小
+
+    struct Report {
+        VertexCacheStats before;
+        VertexCacheStats after;
+
+        void accumulate(const Report& other)
+        {
+            before.triangles += other.before.triangles;
+            before.vertices  += other.before.vertices;
+            before.misses    += other.before.misses;
+            after.triangles  += other.after.triangles;
+            after.vertices   += other.after.vertices;
+            after.misses     += other.after.misses;
+        }
+
+        void print(const std::string& label) const
+        {
+            std::cout << "MESH_OPTIMIZER:: " << label
+                      << " triangles: " << after.triangles
+                      << ", ACMR: " << before.acmr() << " -> " << after.acmr()
+                      << ", ATVR: " << before.atvr() << " -> " << after.atvr() << std::endl;
+        }
+    };
+
+    // 依次执行三角形重排、过度绘制重排与顶点拉取重排，返回优化前后的缓存统计
+    // overdrawThreshold：过度绘制重排允许的 ACMR 上升比例
+    static Report optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, float overdrawThreshold = 1.05f)
+    {
+        Report report;
+        report.before = analyzeVertexCache(indices, vertices.size());
+        if (indices.size() < 3 || vertices.empty()) {
+            report.after = report.before;
+            return report;
+        }
+
+        std::vector<size_t> clusters;
+        std::vector<unsigned int> reordered = tipsify(indices, vertices.size(), CACHE_SIZE, &clusters);
+        optimizeOverdraw(reordered, vertices, clusters, CACHE_SIZE, overdrawThreshold);
+        indices.swap(reordered);
+        optimizeVertexFetch(vertices, indices);
+
+        report.after = analyzeVertexCache(indices, vertices.size());
+        return report;
+    }
+
+    // 用 FIFO 缓存模拟顶点着色器调用次数
+    static VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize = CACHE_SIZE)
+    {
+        VertexCacheStats stats;
+        stats.triangles = indices.size() / 3;
+
+        std::vector<size_t> timestamps(vertexCount, 0);
+        std::vector<bool> used(vertexCount, false);
+        size_t time = cacheSize + 1;
+        for (unsigned int v : indices) {
+            if (v >= vertexCount)
+                continue;
+            if (!used[v]) {
+                used[v] = true;
+                stats.vertices++;
+            }
+            if (time - timestamps[v] > cacheSize) {
+                timestamps[v] = time++;
+                stats.misses++;
+            }
+        }
+        return stats;
+    }
+
+    // Tipsify：围绕扇心顶点输出其所有未输出的三角形，再从候选顶点中选下一个扇心
+    // clusters 返回每个簇起始三角形的下标（缓存被完全刷新处为簇边界）
+    static std::vector<unsigned int> tipsify(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize, std::vector<size_t>* clusters = nullptr)
+    {
+        size_t triangleCount = indices.size() / 3;
+
+        // 顶点 -> 三角形邻接表（CSR）
+        std::vector<unsigned int> live(vertexCount, 0);
+        for (size_t i = 0; i < triangleCount * 3; i++)
+            live[indices[i]]++;
+        std::vector<size_t> offsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; v++)
+            offsets[v + 1] = offsets[v] + live[v];
+        std::vector<unsigned int> adjacency(offsets[vertexCount]);
+        {
+            std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t t = 0; t < triangleCount; t++) {
+                for (int k = 0; k < 3; k++)
+                    adjacency[cursor[indices[t * 3 + k]]++] = (unsigned int)t;
+            }
+        }
+
+        std::vector<size_t> timestamps(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<unsigned int> deadEnd;
+        std::vector<unsigned int> candidates;
+        std::vector<unsigned int> output;
+        output.reserve(triangleCount * 3);
+        if (clusters) {
+            clusters->clear();
+            clusters->push_back(0);
+        }
+
+        size_t time = cacheSize + 1;
+        size_t cursor = 0;
+        long fan = skipDeadEnd(live, deadEnd, cursor);
+        while (fan >= 0) {
+            candidates.clear();
+            for (size_t a = offsets[fan]; a < offsets[fan + 1]; a++) {
+                unsigned int t = adjacency[a];
+                if (emitted[t])
+                    continue;
+                for (int k = 0; k < 3; k++) {
+                    unsigned int v = indices[t * 3 + k];
+                    output.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    live[v]--;
+                    if (time - timestamps[v] > cacheSize)
+                        timestamps[v] = time++;
+                }
+                emitted[t] = true;
+            }
+
+            // 选下一个扇心：优先选仍在缓存中、且输出其剩余三角形后不会被挤出缓存的最旧顶点
+            long next = -1;
+            long best = -1;
+            for (unsigned int v : candidates) {
+                if (live[v] == 0)
+                    continue;
+                long priority = 0;
+                if (time - timestamps[v] + 2 * live[v] <= cacheSize)
+                    priority = (long)(time - timestamps[v]);
+                if (priority > best) {
+                    best = priority;
+                    next = v;
+                }
+            }
+            if (next < 0) {
+                next = skipDeadEnd(live, deadEnd, cursor);
+                // 新扇心已不在缓存中，视为一个簇的结束
+                if (clusters && next >= 0 && time - timestamps[next] > cacheSize && output.size() / 3 > clusters->back())
+                    clusters->push_back(output.size() / 3);
+            }
+            fan = next;
+        }
+        return output;
+    }
+
+    // 过度绘制重排：先在 ACMR 已足够低的位置把大簇继续拆小，再按簇的朝外程度从大到小排序
+    // 朝外程度 = dot(簇中心 - 网格中心, 簇的面积加权法线)，重排后 ACMR 超过阈值时保留原顺序
+    static void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices, const std::vector<size_t>& hardClusters,
+                                 unsigned int cacheSize, float threshold)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2 || hardClusters.empty())
+            return;
+
+        float targetAcmr = analyzeVertexCache(indices, vertices.size(), cacheSize).acmr() * threshold;
+
+        // 1. 软边界：簇内从空缓存开始模拟，ACMR 降到目标以下时切分
+        std::vector<size_t> clusters;
+        std::vector<size_t> timestamps(vertices.size(), 0);
+        size_t time = cacheSize + 1;
+        for (size_t c = 0; c < hardClusters.size(); c++) {
+            size_t begin = hardClusters[c];
+            size_t end = c + 1 < hardClusters.size() ? hardClusters[c + 1] : triangleCount;
+            clusters.push_back(begin);
+            size_t start = begin;
+            size_t misses = 0;
+            time += cacheSize + 1;      // 让所有时间戳失效，相当于清空缓存
+            for (size_t t = begin; t < end; t++) {
+                for (int k = 0; k < 3; k++) {
+                    unsigned int v = indices[t * 3 + k];
+                    if (time - timestamps[v] > cacheSize) {
+                        timestamps[v] = time++;
+                        misses++;
+                    }
+                }
+                if (t + 1 < end && (float)misses / (t - start + 1) <= targetAcmr) {
+                    clusters.push_back(t + 1);
+                    start = t + 1;
+                    misses = 0;
+                    time += cacheSize + 1;
+                }
+            }
+        }
+        if (clusters.size() < 2)
+            return;
+
+        // 2. 网格中心与每个簇的中心、法线（均按面积加权）
+        struct ClusterInfo {
+            size_t begin, end;
+            float sortKey;
+        };
+        std::vector<ClusterInfo> infos(clusters.size());
+        std::vector<glm::vec3> centroids(clusters.size(), glm::vec3(0.0f));
+        std::vector<glm::vec3> normals(clusters.size(), glm::vec3(0.0f));
+        std::vector<float> areas(clusters.size(), 0.0f);
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+        for (size_t c = 0; c < clusters.size(); c++) {
+            infos[c].begin = clusters[c];
+            infos[c].end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+            for (size_t t = infos[c].begin; t < infos[c].end; t++) {
+                const glm::vec3& p0 = vertices[indices[t * 3 + 0]].position;
+                const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+                const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+                glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                float area = glm::length(normal);
+                glm::vec3 center = (p0 + p1 + p2) / 3.0f;
+                centroids[c] += center * area;
+                normals[c] += normal;
+                areas[c] += area;
+            }
+            meshCentroid += centroids[c];
+            meshArea += areas[c];
+        }
+        if (meshArea <= 0.0f)
+            return;
+        meshCentroid /= meshArea;
+        for (size_t c = 0; c < clusters.size(); c++) {
+            glm::vec3 center = areas[c] > 0.0f ? centroids[c] / areas[c] : meshCentroid;
+            infos[c].sortKey = glm::dot(center - meshCentroid, normals[c]);
+        }
+
+        // 3. 朝外的簇先绘制
+        std::stable_sort(infos.begin(), infos.end(), [](const ClusterInfo& a, const ClusterInfo& b) {
+            return a.sortKey > b.sortKey;
+        });
+        std::vector<unsigned int> reordered;
+        reordered.reserve(indices.size());
+        for (const auto& info : infos)
+            reordered.insert(reordered.end(), indices.begin() + info.begin * 3, indices.begin() + info.end * 3);
+
+        if (analyzeVertexCache(reordered, vertices.size(), cacheSize).acmr() <= targetAcmr)
+            indices.swap(reordered);
+    }
+
+    // 按首次使用顺序重新编号顶点，未被引用的顶点被丢弃
+    static void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+    {
+        const unsigned int UNASSIGNED = 0xFFFFFFFFu;
+        std::vector<unsigned int> remap(vertices.size(), UNASSIGNED);
+        unsigned int next = 0;
+        for (auto& index : indices) {
+            if (remap[index] == UNASSIGNED)
+                remap[index] = next++;
+            index = remap[index];
+        }
+
+        std::vector<Vertex> reordered(next);
+        for (size_t v = 0; v < vertices.size(); v++) {
+            if (remap[v] != UNASSIGNED)
+                reordered[remap[v]] = vertices[v];
+        }
+        vertices.swap(reordered);
+    }
+
+private:
+    // 从死端栈中找仍有未输出三角形的顶点，栈空时按顺序扫描
+    static long skipDeadEnd(const std::vector<unsigned int>& live, std::vector<unsigned int>& deadEnd, size_t& cursor)
+    {
+        while (!deadEnd.empty()) {
+            unsigned int v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v] > 0)
+                return v;
+        }
+        while (cursor < live.size()) {
+            if (live[cursor] > 0)
+                return (long)cursor;
+            cursor++;
+        }
+        return -1;
+    }
+};
+
+#endif
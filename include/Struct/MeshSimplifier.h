@@ -0,0 +1,380 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <glm/glm.hpp>
+
+#include "Vertex.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// 一级细节：在网格索引缓冲中的区间与几何误差（模型空间距离）
+struct LodLevel {
+    unsigned int firstIndex = 0;
+    unsigned int indexCount = 0;
+    float error = 0.0f;
+};
+
+// 按投影到屏幕上的误差（像素）选择细节级别：选误差不超过阈值的最粗一级
+// 在模型空间中计算，模型矩阵为均匀缩放时缩放对误差与距离的影响相互抵消
+struct LodSelector {
+    glm::vec3 cameraPosition = glm::vec3(0.0f);    // 模型空间
+    float pixelsPerUnit = 1.0f;                     // 距离为 1 处单位长度对应的像素数
+    float threshold = 1.0f;                         // 允许的屏幕空间误差（像素）
+
+    // fovy 为弧度，viewportHeight 为像素
+    static LodSelector create(float fovy, float viewportHeight, const glm::mat4& model, const glm::vec3& cameraWorldPosition,
+                              float thresholdPixels = 1.0f)
+    {
+        LodSelector selector;
+        selector.cameraPosition = glm::vec3(glm::inverse(model) * glm::vec4(cameraWorldPosition, 1.0f));
+        selector.pixelsPerUnit = viewportHeight / (2.0f * std::tan(fovy * 0.5f));
+        selector.threshold = thresholdPixels;
+        return selector;
+    }
+
+    int select(const std::vector<LodLevel>& levels, const glm::vec3& center, float radius) const
+    {
+        float distance = std::max(glm::length(center - cameraPosition) - radius, 1e-4f);
+        int chosen = 0;
+        for (size_t i = 1; i < levels.size(); i++) {
+            if (levels[i].error * pixelsPerUnit / distance > threshold)
+                break;
+            chosen = (int)i;
+        }
+        return chosen;
+    }
+};
+
+// 二次误差度量（QEM, Garland & Heckbert 1997）网格简化
+// 只做半边折叠（顶点折叠到已有顶点上），简化后的各级只生成新的索引缓冲，与原网格共享顶点缓冲
+// - 同一位置有多个顶点（UV 接缝、硬边）以及开放边界上的顶点保持不动，避免产生裂缝
+// - 折叠代价 = 面积加权的平面距离平方的平均值 + 属性项（法线/UV 差异按边长折算为距离）
+// - 折叠后相邻三角形法线翻转的候选被拒绝
+class MeshSimplifier
+{
+public:
+    static constexpr float LOD_RATIOS[3] = { 0.5f, 0.25f, 0.125f };
+    static constexpr float ATTRIBUTE_WEIGHT = 1.0f;
+
+    // 生成 LOD 链：levels[0] 为原网格（索引区间 [0, indices.size())），其余各级的索引依次追加到 lodIndices
+    // lodIndices 中的 firstIndex 从 indices.size() 开始计，便于与原索引拼接后一次上传
+    static std::vector<LodLevel> buildChain(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                                            std::vector<unsigned int>& lodIndices)
+    {
+        std::vector<LodLevel> levels;
+        LodLevel full;
+        full.indexCount = (unsigned int)indices.size();
+        levels.push_back(full);
+        lodIndices.clear();
+
+        std::vector<unsigned int> current = indices;
+        float error = 0.0f;
+        for (float ratio : LOD_RATIOS) {
+            size_t target = (size_t)(indices.size() / 3 * ratio) * 3;
+            float levelError = 0.0f;
+            std::vector<unsigned int> simplified = simplify(vertices, current, target, &levelError);
+            // 受接缝与边界限制无法继续简化时结束
+            if (simplified.empty() || simplified.size() > current.size() * 9 / 10)
+                break;
+
+            simplified = MeshOptimizer::tipsify(simplified, vertices.size(), MeshOptimizer::CACHE_SIZE);
+            error += levelError;        // 逐级简化，误差保守地累加
+
+            LodLevel level;
+            level.firstIndex = (unsigned int)(indices.size() + lodIndices.size());
+            level.indexCount = (unsigned int)simplified.size();
+            level.error = error;
+            levels.push_back(level);
+            lodIndices.insert(lodIndices.end(), simplified.begin(), simplified.end());
+            current.swap(simplified);
+        }
+        return levels;
+    }
+
+    // 把 indices 简化到不超过 targetIndexCount 个索引（受限时可能更多），error 返回所做折叠的最大几何误差
+    static std::vector<unsigned int> simplify(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                                              size_t targetIndexCount, float* error = nullptr)
+    {
+        std::vector<unsigned int> result = indices;
+        float maxError = 0.0f;
+        if (error)
+            *error = 0.0f;
+        if (indices.size() <= targetIndexCount || vertices.empty())
+            return result;
+
+        // 1. 按位置合并：canonical[v] 为同一位置的第一个顶点
+        std::vector<unsigned int> canonical(vertices.size());
+        std::vector<unsigned int> copies(vertices.size(), 0);
+        {
+            std::unordered_map<PositionKey, unsigned int, PositionKeyHash> unique;
+            unique.reserve(vertices.size());
+            for (size_t v = 0; v < vertices.size(); v++) {
+                auto inserted = unique.emplace(positionKey(vertices[v].position), (unsigned int)v);
+                canonical[v] = inserted.first->second;
+                copies[canonical[v]]++;
+            }
+        }
+
+        // 2. 锁定接缝顶点与开放边界（只被一个三角形使用的边）上的顶点
+        std::vector<bool> locked(vertices.size(), false);
+        for (size_t v = 0; v < vertices.size(); v++)
+            if (copies[canonical[v]] > 1)
+                locked[canonical[v]] = true;
+        {
+            std::unordered_map<uint64_t, unsigned int> edgeUse;
+            edgeUse.reserve(indices.size());
+            for (size_t i = 0; i < indices.size(); i += 3)
+                for (int k = 0; k < 3; k++)
+                    edgeUse[edgeKey(canonical[indices[i + k]], canonical[indices[i + (k + 1) % 3]])]++;
+            for (const auto& edge : edgeUse) {
+                if (edge.second != 2) {
+                    locked[(unsigned int)(edge.first >> 32)] = true;
+                    locked[(unsigned int)(edge.first & 0xFFFFFFFFu)] = true;
+                }
+            }
+        }
+
+        // 3. 每个位置的误差二次型（面积加权的三角形平面）
+        std::vector<Quadric> quadrics(vertices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const glm::vec3& p0 = vertices[indices[i + 0]].position;
+            const glm::vec3& p1 = vertices[indices[i + 1]].position;
+            const glm::vec3& p2 = vertices[indices[i + 2]].position;
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(normal);
+            if (area <= 0.0f)
+                continue;
+            normal = normal * (1.0f / area);
+            Quadric quadric = Quadric::fromPlane(normal, -glm::dot(normal, p0), area);
+            for (int k = 0; k < 3; k++)
+                quadrics[canonical[indices[i + k]]] += quadric;
+        }
+
+        // 4. 逐轮折叠，每轮中一个顶点及其一环邻域只参与一次折叠
+        std::vector<unsigned int> collapse(vertices.size());
+        std::vector<bool> touched(vertices.size());
+        std::vector<Candidate> candidates;
+        std::vector<unsigned int> adjacency;
+        std::vector<unsigned int> offsets;
+        while (result.size() > targetIndexCount) {
+            size_t triangleCount = result.size() / 3;
+            buildAdjacency(result, canonical, vertices.size(), adjacency, offsets);
+
+            // 候选：有向边 a -> b，a 未锁定
+            candidates.clear();
+            for (size_t i = 0; i < result.size(); i += 3) {
+                for (int k = 0; k < 3; k++) {
+                    for (int e = 1; e <= 2; e++) {
+                        unsigned int a = result[i + k];
+                        unsigned int b = result[i + (k + e) % 3];
+                        if (locked[canonical[a]] || canonical[a] == canonical[b])
+                            continue;
+                        Candidate candidate;
+                        candidate.from = a;
+                        candidate.to = b;
+                        candidate.cost = collapseCost(vertices, quadrics, canonical, a, b);
+                        candidates.push_back(candidate);
+                    }
+                }
+            }
+            if (candidates.empty())
+                break;
+            std::sort(candidates.begin(), candidates.end(), [](const Candidate& x, const Candidate& y) {
+                return x.cost < y.cost;
+            });
+
+            for (size_t v = 0; v < vertices.size(); v++)
+                collapse[v] = (unsigned int)v;
+            std::fill(touched.begin(), touched.end(), false);
+
+            // 每次折叠约去掉两个三角形
+            size_t removable = (triangleCount - targetIndexCount / 3 + 1) / 2 + 1;
+            size_t collapsed = 0;
+            for (const Candidate& candidate : candidates) {
+                if (collapsed >= removable)
+                    break;
+                unsigned int ca = canonical[candidate.from];
+                unsigned int cb = canonical[candidate.to];
+                if (touched[ca] || touched[cb])
+                    continue;
+                if (flips(vertices, result, canonical, adjacency, offsets, ca, cb, vertices[candidate.to].position))
+                    continue;
+
+                collapse[candidate.from] = candidate.to;
+                quadrics[cb] += quadrics[ca];
+                maxError = std::max(maxError, candidate.cost);
+                touched[ca] = true;
+                touched[cb] = true;
+                for (size_t n = offsets[ca]; n < offsets[ca + 1]; n++) {
+                    unsigned int t = adjacency[n];
+                    for (int k = 0; k < 3; k++)
+                        touched[canonical[result[t * 3 + k]]] = true;
+                }
+                collapsed++;
+            }
+            if (collapsed == 0)
+                break;
+
+            // 重映射索引并去掉退化三角形
+            size_t write = 0;
+            for (size_t i = 0; i < result.size(); i += 3) {
+                unsigned int i0 = collapse[result[i + 0]];
+                unsigned int i1 = collapse[result[i + 1]];
+                unsigned int i2 = collapse[result[i + 2]];
+                unsigned int c0 = canonical[i0], c1 = canonical[i1], c2 = canonical[i2];
+                if (c0 == c1 || c1 == c2 || c0 == c2)
+                    continue;
+                result[write++] = i0;
+                result[write++] = i1;
+                result[write++] = i2;
+            }
+            result.resize(write);
+        }
+
+        if (error)
+            *error = std::sqrt(maxError);
+        return result;
+    }
+
+private:
+    // 对称 4x4 矩阵的 10 个分量，weight 为累计的面积，用于把误差归一为平均距离平方
+    struct Quadric {
+        double a2 = 0, ab = 0, ac = 0, ad = 0;
+        double b2 = 0, bc = 0, bd = 0;
+        double c2 = 0, cd = 0;
+        double d2 = 0;
+        double weight = 0;
+
+        static Quadric fromPlane(const glm::vec3& n, float d, float w)
+        {
+            Quadric q;
+            q.a2 = w * n.x * n.x; q.ab = w * n.x * n.y; q.ac = w * n.x * n.z; q.ad = w * n.x * d;
+            q.b2 = w * n.y * n.y; q.bc = w * n.y * n.z; q.bd = w * n.y * d;
+            q.c2 = w * n.z * n.z; q.cd = w * n.z * d;
+            q.d2 = w * d * d;
+            q.weight = w;
+            return q;
+        }
+
+        Quadric& operator+=(const Quadric& o)
+        {
+            a2 += o.a2; ab += o.ab; ac += o.ac; ad += o.ad;
+            b2 += o.b2; bc += o.bc; bd += o.bd;
+            c2 += o.c2; cd += o.cd;
+            d2 += o.d2;
+            weight += o.weight;
+            return *this;
+        }
+
+        // 点到所有平面距离平方的加权平均
+        double evaluate(const glm::vec3& p) const
+        {
+            double x = p.x, y = p.y, z = p.z;
+            double e = x * x * a2 + y * y * b2 + z * z * c2
+                     + 2.0 * (x * y * ab + x * z * ac + y * z * bc)
+                     + 2.0 * (x * ad + y * bd + z * cd) + d2;
+            return weight > 0.0 ? std::max(e, 0.0) / weight : 0.0;
+        }
+    };
+
+    struct Candidate {
+        unsigned int from;
+        unsigned int to;
+        float cost;
+    };
+
+    struct PositionKey {
+        uint32_t x, y, z;
+        bool operator==(const PositionKey& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+
+    struct PositionKeyHash {
+        size_t operator()(const PositionKey& key) const
+        {
+            return ((size_t)key.x * 73856093u) ^ ((size_t)key.y * 19349663u) ^ ((size_t)key.z * 83492791u);
+        }
+    };
+
+    static PositionKey positionKey(glm::vec3 position)
+    {
+        position = position + glm::vec3(0.0f);     // 将 -0.0 归一为 +0.0
+        PositionKey key;
+        std::memcpy(&key.x, &position.x, 4);
+        std::memcpy(&key.y, &position.y, 4);
+        std::memcpy(&key.z, &position.z, 4);
+        return key;
+    }
+
+    static uint64_t edgeKey(unsigned int a, unsigned int b)
+    {
+        if (a > b)
+            std::swap(a, b);
+        return ((uint64_t)a << 32) | b;
+    }
+
+    // 几何项 + 属性项：法线或 UV 不连续处的折叠按边长折算为额外的距离平方
+    static float collapseCost(const std::vector<Vertex>& vertices, const std::vector<Quadric>& quadrics,
+                              const std::vector<unsigned int>& canonical, unsigned int a, unsigned int b)
+    {
+        Quadric quadric = quadrics[canonical[a]];
+        quadric += quadrics[canonical[b]];
+        double geometric = quadric.evaluate(vertices[b].position);
+
+        glm::vec3 edge = vertices[b].position - vertices[a].position;
+        glm::vec3 normalDelta = vertices[b].normal - vertices[a].normal;
+        glm::vec2 uvDelta = vertices[b].texCoord - vertices[a].texCoord;
+        double attribute = glm::dot(edge, edge) * ATTRIBUTE_WEIGHT
+                         * (0.25 * glm::dot(normalDelta, normalDelta) + glm::dot(uvDelta, uvDelta));
+        return (float)(geometric + attribute);
+    }
+
+    // 位置 -> 三角形邻接表（CSR）
+    static void buildAdjacency(const std::vector<unsigned int>& indices, const std::vector<unsigned int>& canonical, size_t vertexCount,
+                               std::vector<unsigned int>& adjacency, std::vector<unsigned int>& offsets)
+    {
+        offsets.assign(vertexCount + 1, 0);
+        for (unsigned int index : indices)
+            offsets[canonical[index] + 1]++;
+        for (size_t v = 0; v < vertexCount; v++)
+            offsets[v + 1] += offsets[v];
+        adjacency.resize(indices.size());
+        std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++)
+            adjacency[cursor[canonical[indices[i]]]++] = (unsigned int)(i / 3);
+    }
+
+    // a 移到 target 后，a 周围不含 b 的三角形法线是否翻转（或严重扭曲）
+    static bool flips(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<unsigned int>& canonical,
+                      const std::vector<unsigned int>& adjacency, const std::vector<unsigned int>& offsets,
+                      unsigned int ca, unsigned int cb, const glm::vec3& target)
+    {
+        for (size_t n = offsets[ca]; n < offsets[ca + 1]; n++) {
+            const unsigned int* tri = &indices[adjacency[n] * 3];
+            glm::vec3 before[3], after[3];
+            bool containsB = false;
+            for (int k = 0; k < 3; k++) {
+                unsigned int c = canonical[tri[k]];
+                containsB = containsB || c == cb;
+                before[k] = vertices[tri[k]].position;
+                after[k] = c == ca ? target : before[k];
+            }
+            if (containsB)
+                continue;       // 折叠后退化，会被移除
+            glm::vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+            glm::vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+            float l0 = glm::length(n0);
+            float l1 = glm::length(n1);
+            if (l1 <= 0.0f || glm::dot(n0, n1) <= 0.25f * l0 * l1)
+                return true;
+        }
+        return false;
+    }
+};
+
+#endif
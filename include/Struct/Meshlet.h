@@ -0,0 +1,193 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#include <glm/glm.hpp>
+
+#include "Vertex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// 网格簇（meshlet）：按索引顺序把连续的三角形分成至多 64 个顶点、124 个三角形的簇
+// 每个簇对应网格索引缓冲中的一段连续区间，不需要额外的索引数据；簇旁保存包围球与法线锥，
+// CPU 剔除后把可见区间合并，用一次 glMultiDrawElements 绘制
+// 索引已由 MeshOptimizer 按后变换缓存重排时簇在空间上更紧凑，包围球与法线锥也更紧
+struct Meshlet {
+    static const unsigned int MAX_VERTICES = 64;
+    static const unsigned int MAX_TRIANGLES = 124;
+
+    unsigned int firstIndex = 0;        // 在网格索引数组中的起始位置
+    unsigned int triangleCount = 0;
+    unsigned int vertexCount = 0;       // 簇内不同顶点的数量
+
+    glm::vec3 center = glm::vec3(0.0f); // 包围球（模型空间）
+    float radius = 0.0f;
+    glm::vec3 coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);   // 法线锥轴
+    float coneCutoff = 1.0f;            // sin(锥半角)，>= 1 时不做背面剔除
+
+    // 按索引顺序贪心分簇
+    static std::vector<Meshlet> build(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                                      unsigned int maxVertices = MAX_VERTICES, unsigned int maxTriangles = MAX_TRIANGLES)
+    {
+        std::vector<Meshlet> meshlets;
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+            return meshlets;
+
+        const unsigned int UNSEEN = 0xFFFFFFFFu;
+        std::vector<unsigned int> owner(vertices.size(), UNSEEN);   // 顶点最近一次所属的簇
+        Meshlet current;
+        unsigned int id = 0;
+        for (size_t t = 0; t < triangleCount; t++) {
+            const unsigned int* tri = &indices[t * 3];
+            unsigned int added = countNew(tri, owner, id);
+            if (current.triangleCount > 0 && (current.vertexCount + added > maxVertices || current.triangleCount + 1 > maxTriangles)) {
+                current.computeBounds(vertices, indices);
+                meshlets.push_back(current);
+                current = Meshlet();
+                current.firstIndex = (unsigned int)(t * 3);
+                id++;
+                added = countNew(tri, owner, id);
+            }
+            for (int k = 0; k < 3; k++)
+                owner[tri[k]] = id;
+            current.vertexCount += added;
+            current.triangleCount++;
+        }
+        current.computeBounds(vertices, indices);
+        meshlets.push_back(current);
+        return meshlets;
+    }
+
+    // 包围球取 AABB 中心与最远顶点距离；法线锥轴为单位面法线的平均方向，
+    // 锥半角覆盖所有三角形的法线，张角过大（最小夹角余弦 <= 0.1）时不做背面剔除
+    void computeBounds(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+    {
+        glm::vec3 minimum(std::numeric_limits<float>::max());
+        glm::vec3 maximum(-std::numeric_limits<float>::max());
+        size_t end = firstIndex + triangleCount * 3;
+        for (size_t i = firstIndex; i < end; i++) {
+            minimum = glm::min(minimum, vertices[indices[i]].position);
+            maximum = glm::max(maximum, vertices[indices[i]].position);
+        }
+        center = (minimum + maximum) * 0.5f;
+        float radiusSquared = 0.0f;
+        for (size_t i = firstIndex; i < end; i++) {
+            glm::vec3 offset = vertices[indices[i]].position - center;
+            radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+        }
+        radius = std::sqrt(radiusSquared);
+
+        std::vector<glm::vec3> normals;
+        normals.reserve(triangleCount);
+        glm::vec3 axis(0.0f);
+        for (size_t i = firstIndex; i < end; i += 3) {
+            const glm::vec3& p0 = vertices[indices[i + 0]].position;
+            const glm::vec3& p1 = vertices[indices[i + 1]].position;
+            const glm::vec3& p2 = vertices[indices[i + 2]].position;
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float length = glm::length(normal);
+            if (length <= 1e-12f)
+                continue;       // 退化三角形不参与
+            normals.push_back(normal / length);
+            axis += normals.back();
+        }
+
+        coneCutoff = 1.0f;
+        float axisLength = glm::length(axis);
+        if (normals.empty() || axisLength <= 1e-6f)
+            return;
+        coneAxis = axis / axisLength;
+        float minDot = 1.0f;
+        for (const glm::vec3& normal : normals)
+            minDot = std::min(minDot, glm::dot(coneAxis, normal));
+        if (minDot > 0.1f)
+            coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+
+private:
+    static unsigned int countNew(const unsigned int* tri, const std::vector<unsigned int>& owner, unsigned int id)
+    {
+        unsigned int added = 0;
+        for (int k = 0; k < 3; k++) {
+            bool repeated = (k > 0 && tri[k] == tri[0]) || (k > 1 && tri[k] == tri[1]);
+            if (owner[tri[k]] != id && !repeated)
+                added++;
+        }
+        return added;
+    }
+};
+
+// 簇剔除：在模型空间中进行，视锥平面取自 projection * view * model，相机位置变换到模型空间
+// 背面剔除：dot(center - camera, axis) >= cutoff * |center - camera| + radius 时簇内所有三角形都背对相机
+// 注意：模型矩阵含非均匀缩放时法线锥不再准确，此时应关闭 backfaceCulling
+struct MeshletCuller {
+    glm::vec4 planes[6];
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+    bool backfaceCulling = true;
+
+    // 统计（同一个剔除器可用于多个网格）
+    mutable size_t tested = 0;
+    mutable size_t frustumCulled = 0;
+    mutable size_t backfaceCulled = 0;
+
+    static MeshletCuller create(const glm::mat4& projection, const glm::mat4& view, const glm::mat4& model, const glm::vec3& cameraWorldPosition)
+    {
+        MeshletCuller culler;
+        glm::mat4 clip = projection * view * model;
+        for (int i = 0; i < 3; i++) {
+            glm::vec4 row(clip[0][i], clip[1][i], clip[2][i], clip[3][i]);
+            glm::vec4 w(clip[0][3], clip[1][3], clip[2][3], clip[3][3]);
+            culler.planes[i * 2 + 0] = w + row;
+            culler.planes[i * 2 + 1] = w - row;
+        }
+        for (auto& plane : culler.planes) {
+            float length = glm::length(glm::vec3(plane));
+            if (length > 0.0f)
+                plane = plane * (1.0f / length);
+        }
+        culler.cameraPosition = glm::vec3(glm::inverse(model) * glm::vec4(cameraWorldPosition, 1.0f));
+        return culler;
+    }
+
+    bool visible(const Meshlet& meshlet) const
+    {
+        tested++;
+        for (const auto& plane : planes) {
+            if (glm::dot(glm::vec3(plane), meshlet.center) + plane.w < -meshlet.radius) {
+                frustumCulled++;
+                return false;
+            }
+        }
+        if (backfaceCulling && meshlet.coneCutoff < 1.0f) {
+            glm::vec3 toCenter = meshlet.center - cameraPosition;
+            if (glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius) {
+                backfaceCulled++;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void resetStats() const
+    {
+        tested = 0;
+        frustumCulled = 0;
+        backfaceCulled = 0;
+    }
+
+    void printStats() const
+    {
+        size_t visibleCount = tested - frustumCulled - backfaceCulled;
+        std::cout << "MESHLET::CULLING:: clusters: " << tested
+                  << ", visible: " << visibleCount
+                  << ", frustum culled: " << frustumCulled
+                  << ", backface culled: " << backfaceCulled
+                  << " (" << (tested ? 100.0f * visibleCount / tested : 0.0f) << "% drawn)" << std::endl;
+    }
+};
+
+#endif
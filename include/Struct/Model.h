@@ -7,9 +7,18 @@
 #include <assimp/postprocess.h>
 
 #include "Mesh.h"
+#include "MeshCache.h"
+#include "ThreadPool.h"
 #include "Shader/Shader.h"
+#include "Render/MultiDrawBatch.h"
+#include "Render/BonePaletteBuffer.h"
+#include "Animation/Skeleton.h"
+#include "Animation/AnimationClipStore.h"
+#include "ProcessMemory.h"
 
 #include <map>
+#include <algorithm>
+#include <chrono>
 using namespace std;
 
 unsigned int TextureFromFile(const char *path, const string &directory, bool gamma = false);
@@ -22,9 +31,16 @@ public:
     vector<Mesh>    meshes;
     string directory;
     bool gammaCorrection;
+    MeshOptions meshOptions;            // 网格上传到 GPU 时的选项（顶点格式、位置流）
+    MeshOptimizer::Report vertexCacheReport;    // 导入时所有网格优化前后的顶点缓存统计
+    VertexWelder::Report weldReport;            // 导入时所有网格焊接前后的顶点数
+    MultiDrawBatch drawBatch;           // meshOptions.useArena 时所有子网格合批绘制
+    Skeleton skeleton;                  // 网格带骨骼时的节点层级与逆绑定矩阵
+    AnimationClipStore animations;      // 场景中的动画，按骨架节点重采样（meshOptions.compressAnimations 时压缩）
 
     // constructor, expects a filepath to a 3D model.
-    Model(string const &path, bool gamma = false) : gammaCorrection(gamma)
+    // options.vertexFormat 为 VertexFormat::PACKED 时顶点量化（全部属性时为 36 字节）；只上传网格实际拥有的属性
+    Model(string const &path, bool gamma = false, const MeshOptions& options = MeshOptions()) : gammaCorrection(gamma), meshOptions(options)
     {
         loadModel(path);
     }
@@ -39,6 +55,12 @@ public:
         , meshes(std::move(other.meshes))
         , directory(std::move(other.directory))
         , gammaCorrection(other.gammaCorrection)
+        , meshOptions(other.meshOptions)
+        , vertexCacheReport(other.vertexCacheReport)
+        , weldReport(other.weldReport)
+        , drawBatch(std::move(other.drawBatch))
+        , skeleton(std::move(other.skeleton))
+        , animations(std::move(other.animations))
     {}
     
     Model& operator=(Model&& other) noexcept {
@@ -47,24 +69,106 @@ public:
             meshes = std::move(other.meshes);
             directory = std::move(other.directory);
             gammaCorrection = other.gammaCorrection;
+            meshOptions = other.meshOptions;
+            vertexCacheReport = other.vertexCacheReport;
+            weldReport = other.weldReport;
+            drawBatch = std::move(other.drawBatch);
+            skeleton = std::move(other.skeleton);
+            animations = std::move(other.animations);
         }
         return *this;
     }
 
     // render the model, and thus all its meshes
+    // 子网格位于 GeometryArena 时按池与纹理分组，每组一次多重间接绘制（GL 3.3 下每组一次 VAO/纹理绑定的循环）
     bool render(Shader &shader)
     {
+        if (meshOptions.useArena && drawBatch.render(shader, meshes))
+            return true;
         for(unsigned int i = 0; i < meshes.size(); i++)
             if (!meshes[i].render(shader)) {
                 return false;
             }
         return true;
     }
+
+    // 簇级剔除后绘制（meshOptions.meshlets 为 true 时生效，否则与逐网格 render 相同）
+    // culler 每帧由 MeshletCuller::create(projection, view, model, cameraPosition) 生成
+    bool renderCulled(Shader &shader, const MeshletCuller &culler)
+    {
+        for(unsigned int i = 0; i < meshes.size(); i++)
+            if (!meshes[i].renderCulled(shader, culler)) {
+                return false;
+            }
+        return true;
+    }
+
+    // 按屏幕空间误差为每个子网格选择细节级别（meshOptions.lodChain 为 true 时生效，否则与 render 相同）
+    // selector 每帧由 LodSelector::create(fovy, viewportHeight, model, cameraPosition) 生成
+    bool renderLod(Shader &shader, const LodSelector &selector)
+    {
+        for(unsigned int i = 0; i < meshes.size(); i++) {
+            const Mesh& mesh = meshes[i];
+            if (!mesh.renderLod(shader, selector.select(mesh.lods, mesh.boundsCenter, mesh.boundsRadius))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 蒙皮绘制：shader 为 skinning.vs 的程序，palette 中本角色的调色板从第 paletteOffset 根骨骼开始
+    // 调色板由 PoseEvaluator(skeleton, animations) 求值后每帧整体上传
+    bool renderSkinned(Shader &shader, const BonePaletteBuffer &palette, unsigned int paletteOffset)
+    {
+        shader.use();
+        palette.bind(shader, paletteOffset);
+        return render(shader);
+    }
+
+    // 深度/阴影通道：depthShader 只需要 location = 0 的位置属性
+    bool renderDepth(const Shader &depthShader)
+    {
+        depthShader.use();
+        for(unsigned int i = 0; i < meshes.size(); i++)
+            if (!meshes[i].renderDepth()) {
+                return false;
+            }
+        return true;
+    }
     
 private:
+    // CPU 阶段的转换结果，等待 GL 阶段按顺序上传
+    struct StagedMesh {
+        const aiMesh* source = nullptr;
+        uint32_t attributes = 0;
+        vector<vector<Vertex>> vertices;            // 拆分后每块一项，未拆分时只有一项
+        vector<vector<unsigned int>> indices;
+        size_t vertexCount = 0;                     // 拆分前的顶点数
+        bool split = false;
+        vector<string> boneNames;                   // 网格内的局部骨骼，顶点的 m_BoneIDs 为其中的下标
+        vector<glm::mat4> boneOffsets;
+        bool tangentsGenerated = false;
+        TangentGenerator::Report tangentReport;
+        VertexWelder::Report weldReport;
+        MeshOptimizer::Report vertexCacheReport;
+    };
+
     // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
     void loadModel(string const &path)
     {
+        size_t residentBefore = ProcessMemory::currentResidentBytes();
+        auto start = std::chrono::high_resolution_clock::now();
+
+        // 烘焙缓存命中时映射缓存文件直接上传，不再运行 assimp
+        MeshCache& cache = MeshCache::instance();
+        bool cacheable = cache.enabled() && MeshCache::supports(meshOptions);
+        uint64_t cacheKey = cacheable ? MeshCache::makeKey(meshOptions) : 0;
+        if (cacheable && loadCooked(path, cacheKey, start)) {
+            reportVertexMemory(path);
+            reportResidentMemory(path, residentBefore);
+            return;
+        }
+
         // 通过 assimp 读取文件
         Assimp::Importer importer;
         const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
@@ -80,35 +184,334 @@ private:
         // 获取文件路径所在的目标路径
         directory = path.substr(0, path.find_last_of('/'));
 
-        // 递归处理 assimp 的根节点
-        processNode(scene->mRootNode, scene);
+        // 并行转换所有网格，再按节点顺序上传
+        processScene(scene, path);
+
+        // 骨骼在处理网格时注册，之后按场景层级建立节点并重采样动画
+        size_t keyCount = 0;
+        if (!skeleton.empty()) {
+            loadSkeleton(scene->mRootNode, -1);
+            skeleton.globalInverse = glm::inverse(toMat4(scene->mRootNode->mTransformation));
+            keyCount = loadAnimations(scene);
+        }
+
+        // 烘焙在压缩动画之前进行，缓存中保存重采样的原始帧，命中时按当时的选项压缩
+        if (cacheable) {
+            double assimpMilliseconds = millisecondsSince(start);
+            cache.report(path, false, assimpMilliseconds);
+            cache.store(path, cacheKey, meshes, skeleton, animations, keyCount, assimpMilliseconds);
+        }
+        if (!skeleton.empty())
+            finishAnimations(path, keyCount);
+
+        if (meshOptions.weldVertices && weldReport.before > 0)
+            weldReport.print(path);
+        if (meshOptions.optimizeVertexCache && vertexCacheReport.before.triangles > 0)
+            vertexCacheReport.print(path);
+        reportVertexMemory(path);
+
+        importer.FreeScene();
+        reportResidentMemory(path, residentBefore);
     }
 
-    // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
-    void processNode(aiNode *node, const aiScene *scene)
+    // 从烘焙缓存加载：纹理按引用重新加载，网格直接从映射的文件页上传，上传完成后解除映射
+    bool loadCooked(string const &path, uint64_t cacheKey, std::chrono::high_resolution_clock::time_point start)
     {
-        // 处理当前节点所有的网格
-        for(unsigned int i = 0; i < node->mNumMeshes; i++)
-        {
-            // the node object only contains indices to index the actual objects in the scene. 
-            // the scene contains all the data, node is just to keep stuff organized (like relations between nodes).
-            aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            meshes.push_back(processMesh(mesh, scene));
+        MeshCache::CookedModel cooked;
+        if (!MeshCache::instance().load(path, cacheKey, cooked))
+            return false;
+        directory = path.substr(0, path.find_last_of('/'));
+
+        vector<Texture> textures;
+        textures.reserve(cooked.textures.size());
+        for (const Texture& reference : cooked.textures) {
+            Texture texture = loadTexture(reference.path.c_str(), reference.type);
+            texture.type = reference.type;
+            textures.push_back(texture);
+        }
+
+        meshes.reserve(meshes.size() + cooked.meshes.size());
+        for (const MeshCache::CookedMesh& source : cooked.meshes) {
+            vector<Texture> meshTextures;
+            meshTextures.reserve(source.textures.size());
+            for (uint32_t t : source.textures)
+                meshTextures.push_back(textures[t]);
+            meshes.emplace_back(source.vertexData, source.vertexCount, source.indexData, source.indexCount, source.indexType,
+                                std::move(meshTextures), source.vertexFormat, source.attributeMask);
+            meshes.back().boundsCenter = source.boundsCenter;
+            meshes.back().boundsRadius = source.boundsRadius;
         }
+
+        skeleton = std::move(cooked.skeleton);
+        for (AnimationClip& clip : cooked.clips)
+            animations.add(std::move(clip));
+        if (!skeleton.empty())
+            finishAnimations(path, cooked.sourceKeys);
+
+        MeshCache::instance().report(path, true, millisecondsSince(start), cooked.assimpMilliseconds, cooked.residentFraction);
+        return true;
+    }
+
+    static double millisecondsSince(std::chrono::high_resolution_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    // 峰值出现在 aiScene 与转换后的网格数据同时存在时；释放 CPU 数据后加载结束时的常驻内存应明显回落
+    void reportResidentMemory(string const &path, size_t residentBefore) const
+    {
+        cout << "MODEL::MEMORY:: " << path
+             << " peak RSS: " << ProcessMemory::peakResidentBytes() / (1024.0f * 1024.0f) << " MB"
+             << ", before load: " << residentBefore / (1024.0f * 1024.0f) << " MB"
+             << ", after load: " << ProcessMemory::currentResidentBytes() / (1024.0f * 1024.0f) << " MB"
+             << ", CPU mesh data " << (meshOptions.cpuAccess ? "kept" : "released") << endl;
+    }
+
+    // aiMatrix4x4 为行主序，glm 为列主序
+    static glm::mat4 toMat4(const aiMatrix4x4& m)
+    {
+        glm::mat4 result;
+        result[0] = glm::vec4(m.a1, m.b1, m.c1, m.d1);
+        result[1] = glm::vec4(m.a2, m.b2, m.c2, m.d2);
+        result[2] = glm::vec4(m.a3, m.b3, m.c3, m.d3);
+        result[3] = glm::vec4(m.a4, m.b4, m.c4, m.d4);
+        return result;
+    }
+
+    // 写入顶点的骨骼索引与权重（每个顶点至多 MAX_BONE_INFLUENCE 个，多余的丢弃权重最小的）
+    // 在工作线程中执行，不访问骨架：骨骼按名称在网格内编号，m_BoneIDs 暂存局部下标，上传前由 registerBones 映射到骨架
+    static void extractBones(const aiMesh* mesh, vector<Vertex>& vertices, StagedMesh& staged)
+    {
+        for (unsigned int b = 0; b < mesh->mNumBones; b++) {
+            const aiBone* bone = mesh->mBones[b];
+            int boneId = 0;
+            while (boneId < (int)staged.boneNames.size() && staged.boneNames[boneId] != bone->mName.C_Str())
+                boneId++;
+            if (boneId == (int)staged.boneNames.size()) {
+                staged.boneNames.push_back(bone->mName.C_Str());
+                staged.boneOffsets.push_back(toMat4(bone->mOffsetMatrix));
+            }
+            for (unsigned int w = 0; w < bone->mNumWeights; w++) {
+                const aiVertexWeight& weight = bone->mWeights[w];
+                if (weight.mVertexId >= vertices.size() || weight.mWeight <= 0.0f)
+                    continue;
+                Vertex& vertex = vertices[weight.mVertexId];
+                addBoneInfluence(vertex.m_BoneIDs, vertex.m_Weights, boneId, weight.mWeight, MAX_BONE_INFLUENCE);
+            }
+        }
+        for (Vertex& vertex : vertices)
+            normalizeBoneWeights(vertex.m_Weights, MAX_BONE_INFLUENCE);
+    }
+
+    // 按网格顺序把局部骨骼注册到骨架（骨骼下标与串行导入时相同），并改写顶点中有权重的骨骼索引
+    // 网格内的骨骼名互不相同，局部到全局的映射是单射，焊接时的比较结果不受影响
+    void registerBones(StagedMesh& staged)
+    {
+        if (staged.boneNames.empty())
+            return;
+        vector<int> boneIds(staged.boneNames.size());
+        for (size_t b = 0; b < staged.boneNames.size(); b++)
+            boneIds[b] = skeleton.addBone(staged.boneNames[b], staged.boneOffsets[b]);
+        for (vector<Vertex>& chunk : staged.vertices) {
+            for (Vertex& vertex : chunk) {
+                for (int k = 0; k < MAX_BONE_INFLUENCE; k++) {
+                    if (vertex.m_Weights[k] > 0.0f)
+                        vertex.m_BoneIDs[k] = boneIds[vertex.m_BoneIDs[k]];
+                }
+            }
+        }
+    }
+
+    // 按先序遍历加入节点，保证父节点在前
+    void loadSkeleton(const aiNode* node, int parent)
+    {
+        int index = skeleton.addNode(node->mName.C_Str(), parent, toMat4(node->mTransformation));
+        for (unsigned int i = 0; i < node->mNumChildren; i++)
+            loadSkeleton(node->mChildren[i], index);
+    }
+
+    // 动画通道按节点名对应到骨架节点，时间从 tick 换算为秒后重采样，返回源关键帧数
+    size_t loadAnimations(const aiScene* scene)
+    {
+        size_t keyCount = 0;
+        for (unsigned int a = 0; a < scene->mNumAnimations; a++) {
+            const aiAnimation* animation = scene->mAnimations[a];
+            double ticksPerSecond = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : 25.0;
+            vector<AnimationClip::SourceChannel> channels(skeleton.nodeCount());
+            for (unsigned int c = 0; c < animation->mNumChannels; c++) {
+                const aiNodeAnim* source = animation->mChannels[c];
+                int node = skeleton.findNode(source->mNodeName.C_Str());
+                if (node < 0)
+                    continue;
+                AnimationClip::SourceChannel& channel = channels[node];
+                for (unsigned int k = 0; k < source->mNumPositionKeys; k++) {
+                    const aiVectorKey& key = source->mPositionKeys[k];
+                    channel.positionTimes.push_back((float)(key.mTime / ticksPerSecond));
+                    channel.positions.push_back(glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z));
+                }
+                for (unsigned int k = 0; k < source->mNumRotationKeys; k++) {
+                    const aiQuatKey& key = source->mRotationKeys[k];
+                    channel.rotationTimes.push_back((float)(key.mTime / ticksPerSecond));
+                    channel.rotations.push_back(glm::vec4(key.mValue.x, key.mValue.y, key.mValue.z, key.mValue.w));
+                }
+                for (unsigned int k = 0; k < source->mNumScalingKeys; k++) {
+                    const aiVectorKey& key = source->mScalingKeys[k];
+                    channel.scaleTimes.push_back((float)(key.mTime / ticksPerSecond));
+                    channel.scales.push_back(glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z));
+                }
+                keyCount += channel.keyCount();
+            }
+            string name = animation->mName.length > 0 ? string(animation->mName.C_Str()) : "clip" + to_string(a);
+            animations.add(AnimationClip::resample(name, (float)(animation->mDuration / ticksPerSecond), channels, skeleton));
+        }
+        return keyCount;
+    }
+
+    // 按选项压缩动画片段并输出统计
+    void finishAnimations(string const &path, size_t keyCount)
+    {
+        size_t resampledBytes = animations.memoryBytes();
+        if (meshOptions.compressAnimations) {
+            animations.compress();
+            animations.printStats();
+        }
+
+        cout << "MODEL::ANIMATION:: " << path
+             << " bones: " << skeleton.boneCount()
+             << ", nodes: " << skeleton.nodeCount()
+             << ", clips: " << animations.size()
+             << ", source keys: " << keyCount
+             << ", resampled: " << resampledBytes / 1024.0f << " KB"
+             << ", stored: " << animations.memoryBytes() / 1024.0f << " KB" << endl;
+    }
+
+    // 输出顶点缓冲占用：完整格式应占用的大小与实际上传的大小
+    // 每次顶点拉取读取的字节数与步长成正比，因此两者之比也是顶点拉取带宽之比
+    void reportVertexMemory(string const &path) const
+    {
+        size_t vertexCount = 0;
+        size_t fullBytes = 0;
+        size_t uploadedBytes = 0;
+        size_t indexCount = 0;
+        size_t indexBytes = 0;
+        size_t positionCount = 0;
+        size_t positionBytes = 0;
+        size_t meshletCount = 0;
+        size_t meshletVertices = 0;
+        vector<size_t> lodTriangles;
+        vector<float> lodErrors;
+        for (const auto& mesh : meshes) {
+            for (size_t level = 1; level < mesh.lods.size(); level++) {
+                if (lodTriangles.size() < level) {
+                    lodTriangles.resize(level, 0);
+                    lodErrors.resize(level, 0.0f);
+                }
+                lodTriangles[level - 1] += mesh.lods[level].indexCount / 3;
+                lodErrors[level - 1] = std::max(lodErrors[level - 1], mesh.lods[level].error);
+            }
+            meshletCount += mesh.meshlets.size();
+            for (const auto& meshlet : mesh.meshlets)
+                meshletVertices += meshlet.vertexCount;
+            vertexCount += mesh.vertexCount;
+            fullBytes += mesh.vertexCount * sizeof(Vertex);
+            uploadedBytes += mesh.vertexBufferSize;
+            indexCount += mesh.indexCount();
+            indexBytes += mesh.indexBufferSize;
+            positionCount += mesh.positionStream.positionCount;
+            positionBytes += mesh.positionStream.memoryBytes();
+        }
+        if (vertexCount == 0)
+            return;
+
+        cout << "MODEL::VERTEX_MEMORY:: " << path
+             << " vertices: " << vertexCount
+             << ", full: " << fullBytes / 1024.0f << " KB (" << sizeof(Vertex) << " B/vertex)"
+             << ", uploaded: " << uploadedBytes / 1024.0f << " KB (" << (float)uploadedBytes / vertexCount << " B/vertex)"
+             << ", saved " << 100.0f * (1.0f - (float)uploadedBytes / fullBytes) << "%" << endl;
+        if (indexCount > 0)
+            cout << "MODEL::INDEX_MEMORY:: indices: " << indexCount
+                 << ", 32-bit: " << indexCount * sizeof(unsigned int) / 1024.0f << " KB"
+                 << ", uploaded: " << indexBytes / 1024.0f << " KB" << endl;
+        if (positionCount > 0)
+            cout << "MODEL::POSITION_STREAM:: positions: " << positionCount << " (welded from " << vertexCount << ")"
+                 << ", " << positionBytes / 1024.0f << " KB, depth pass fetches " << sizeof(glm::vec3) << " B/vertex" << endl;
+        if (meshletCount > 0)
+            cout << "MODEL::MESHLETS:: clusters: " << meshletCount
+                 << ", avg triangles: " << (float)indexCount / 3 / meshletCount
+                 << ", avg vertices: " << (float)meshletVertices / meshletCount
+                 << ", bounds: " << meshletCount * sizeof(Meshlet) / 1024.0f << " KB" << endl;
+        for (size_t level = 0; level < lodTriangles.size(); level++)
+            cout << "MODEL::LOD:: level " << level + 1 << " triangles: " << lodTriangles[level]
+                 << " (" << 100.0f * lodTriangles[level] * 3 / indexCount << "%), max error: " << lodErrors[level] << endl;
+    }
+
+    // 按先序遍历收集节点引用的网格（同一个 aiMesh 被多个节点引用时出现多次），该顺序即 meshes 的顺序
+    void processNode(const aiNode *node, const aiScene *scene, vector<const aiMesh*>& sources)
+    {
+        // the node object only contains indices to index the actual objects in the scene. 
+        // the scene contains all the data, node is just to keep stuff organized (like relations between nodes).
+        for(unsigned int i = 0; i < node->mNumMeshes; i++)
+            sources.push_back(scene->mMeshes[node->mMeshes[i]]);
         // 对它的子节点重复该过程
         for(unsigned int i = 0; i < node->mNumChildren; i++)
-        {
-            processNode(node->mChildren[i], scene);
+            processNode(node->mChildren[i], scene, sources);
+    }
+
+    // 两阶段导入：
+    // 1. CPU 阶段：在 ThreadPool 上并行转换每个 aiMesh（顶点与索引拷贝、骨骼权重、切线、焊接、重排、拆分），结果放入暂存区
+    // 2. GL 阶段：在调用线程中按收集顺序注册骨骼、加载材质纹理并创建缓冲，meshes 的顺序、骨骼下标与串行导入相同
+    // 所有暂存网格在 GL 阶段之前同时存在，加载时的峰值内存比逐个转换上传略高
+    void processScene(const aiScene *scene, string const &path)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        vector<const aiMesh*> sources;
+        processNode(scene->mRootNode, scene, sources);
+
+        // 网格大小差别很大，每块一个网格，由原子计数动态领取
+        ThreadPool& pool = ThreadPool::instance();
+        vector<StagedMesh> staged(sources.size());
+        pool.parallelFor(sources.size(), 1, [this, &sources, &staged](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                stageMesh(sources[i], staged[i]);
+        });
+        double convertMilliseconds = millisecondsSince(start);
+
+        // 先预留，避免 meshes 扩容时反复移动
+        meshes.reserve(meshes.size() + sources.size());
+        for (StagedMesh& mesh : staged) {
+            uploadMesh(mesh, scene);
         }
 
+        cout << "MODEL::IMPORT:: " << path
+             << " meshes: " << sources.size()
+             << ", convert: " << convertMilliseconds << " ms (" << std::min(pool.threadCount() + 1, std::max<size_t>(sources.size(), 1)) << " threads)"
+             << ", upload: " << millisecondsSince(start) - convertMilliseconds << " ms" << endl;
     }
 
-    Mesh processMesh(aiMesh *mesh, const aiScene *scene)
+    // CPU 阶段：转换一个 aiMesh 并完成焊接、重排与拆分；在工作线程中执行，不访问 GL，也不修改 Model 的成员
+    void stageMesh(const aiMesh *mesh, StagedMesh& staged) const
     {
+        staged.source = mesh;
         // 需要填充的数据
         vector<Vertex> vertices;
         vector<unsigned int> indices;
-        vector<Texture> textures;
+        vertices.reserve(mesh->mNumVertices);
+        indices.reserve(mesh->mNumFaces * 3);
+
+        // 根据网格实际拥有的数据确定需要上传的顶点属性
+        uint32_t attributes = VertexLayout::POSITION_BIT;
+        if (mesh->HasNormals())
+            attributes |= VertexLayout::NORMAL_BIT;
+        if (mesh->mTextureCoords[0])
+            attributes |= VertexLayout::TEXCOORD_BIT;
+        // 有纹理坐标时总是上传切线空间：assimp 没有给出切线时由 TangentGenerator 生成
+        if (mesh->mTextureCoords[0] && mesh->HasNormals())
+            attributes |= VertexLayout::TANGENT_BIT | VertexLayout::BITANGENT_BIT;
+        if (mesh->HasVertexColors(0))
+            attributes |= VertexLayout::COLOR_BIT;
+        if (mesh->HasBones())
+            attributes |= VertexLayout::BONE_IDS_BIT | VertexLayout::WEIGHTS_BIT;
+        staged.attributes = attributes;
 
         // 遍历网格的每个顶点
         for(unsigned int i = 0; i < mesh->mNumVertices; i++)
@@ -141,33 +544,101 @@ private:
                 vec.y = mesh->mTextureCoords[0][i].y;
                 vertex.texCoord = vec;
 
-                // tangent
-                vector.x = mesh->mTangents[i].x;
-                vector.y = mesh->mTangents[i].y;
-                vector.z = mesh->mTangents[i].z;
-                vertex.tangent = vector;
-
-                // bitangent
-                vector.x = mesh->mBitangents[i].x;
-                vector.y = mesh->mBitangents[i].y;
-                vector.z = mesh->mBitangents[i].z;
-                vertex.bitangent = vector;
+                if (mesh->HasTangentsAndBitangents())
+                {
+                    // tangent
+                    vector.x = mesh->mTangents[i].x;
+                    vector.y = mesh->mTangents[i].y;
+                    vector.z = mesh->mTangents[i].z;
+                    vertex.tangent = vector;
+
+                    // bitangent
+                    vector.x = mesh->mBitangents[i].x;
+                    vector.y = mesh->mBitangents[i].y;
+                    vector.z = mesh->mBitangents[i].z;
+                    vertex.bitangent = vector;
+                }
             }
             else
                 vertex.texCoord = glm::vec2(0.0f, 0.0f);
 
+            // vertex color
+            if (mesh->HasVertexColors(0))
+            {
+                vertex.color = glm::vec3(mesh->mColors[0][i].r, mesh->mColors[0][i].g, mesh->mColors[0][i].b);
+            }
+
             vertices.push_back(vertex);
         }
+        // 骨骼索引与权重（焊接与重排之前写入，两者都会带着骨骼数据一起处理）
+        if (mesh->HasBones())
+            extractBones(mesh, vertices, staged);
+
         // now wak through each of the mesh's faces (a face is a mesh its triangle) and retrieve the corresponding vertex indices.
         for(unsigned int i = 0; i < mesh->mNumFaces; i++)
         {
-            aiFace face = mesh->mFaces[i];
+            const aiFace& face = mesh->mFaces[i];
             // retrieve all indices of the face and store them in the indices vector
             for(unsigned int j = 0; j < face.mNumIndices; j++)
                 indices.push_back(face.mIndices[j]);        
         }
+        // assimp 没有给出切线时（aiProcess_CalcTangentSpace 跳过了该网格）自行生成；切线参与焊接比较，因此在焊接之前进行
+        // 三角形多的网格在生成切线时还会嵌套使用线程池：调用线程自行领取剩余的块，不会等待被占用的工作线程
+        if (mesh->mTextureCoords[0] && mesh->HasNormals() && !mesh->HasTangentsAndBitangents()) {
+            staged.tangentReport = TangentGenerator::generate(vertices, indices);
+            staged.tangentsGenerated = true;
+        }
+        // 合并重复顶点（OBJ 等格式按面存储顶点，导入时未使用 aiProcess_JoinIdenticalVertices）
+        if (meshOptions.weldVertices)
+            staged.weldReport = VertexWelder::weld(vertices, indices, meshOptions.weldEpsilon);
+
+        // 上传前重排三角形与顶点；拆分按三角形顺序进行，重排后的局部性在每块中得以保留
+        if (meshOptions.optimizeVertexCache)
+            staged.vertexCacheReport = MeshOptimizer::optimize(vertices, indices);
+
+        staged.vertexCount = vertices.size();
+        if (meshOptions.splitLargeMeshes && vertices.size() > meshOptions.maxVerticesPerMesh) {
+            splitMesh(vertices, indices, meshOptions.maxVerticesPerMesh, staged.vertices, staged.indices);
+            staged.split = true;
+            return;
+        }
+        staged.vertices.push_back(std::move(vertices));
+        staged.indices.push_back(std::move(indices));
+    }
+
+    // GL 阶段：按顺序输出转换时的统计、注册骨骼、加载材质纹理并创建 Mesh
+    void uploadMesh(StagedMesh& staged, const aiScene *scene)
+    {
+        const aiMesh* mesh = staged.source;
+        registerBones(staged);
+        if (staged.tangentsGenerated)
+            staged.tangentReport.print(string("MODEL::TANGENTS ") + mesh->mName.C_Str());
+        if (meshOptions.weldVertices) {
+            if (staged.weldReport.after < staged.weldReport.before)
+                staged.weldReport.print(string("MODEL::WELD ") + mesh->mName.C_Str());
+            weldReport.accumulate(staged.weldReport);
+        }
+        if (meshOptions.optimizeVertexCache)
+            vertexCacheReport.accumulate(staged.vertexCacheReport);
+
         // process materials
-        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];    
+        vector<Texture> textures = loadMeshTextures(scene->mMaterials[mesh->mMaterialIndex]);
+
+        // create mesh objects from the extracted mesh data
+        if (staged.split) {
+            cout << "MODEL::SPLIT_MESH:: " << mesh->mName.C_Str() << " " << staged.vertexCount << " vertices -> "
+                 << staged.vertices.size() << " meshes" << endl;
+            for (size_t i = 0; i < staged.vertices.size(); i++)
+                meshes.emplace_back(std::move(staged.vertices[i]), std::move(staged.indices[i]), textures, meshOptions, staged.attributes);
+            return;
+        }
+        meshes.emplace_back(std::move(staged.vertices[0]), std::move(staged.indices[0]), std::move(textures), meshOptions, staged.attributes);
+    }
+
+    // 网格材质引用的纹理，按着色器中的采样器命名约定分类（需要 GL，只在 GL 阶段调用）
+    vector<Texture> loadMeshTextures(aiMaterial *material)
+    {
+        vector<Texture> textures;
         // we assume a convention for sampler names in the shaders. Each diffuse texture should be named
         // as 'texture_diffuseN' where N is a sequential number ranging from 1 to MAX_SAMPLER_NUMBER. 
         // Same applies to other texture as the following list summarizes:
@@ -222,8 +693,43 @@ private:
         // }
         textures.insert(textures.end(), reflectMaps.begin(), reflectMaps.end());
         
-        // return a mesh object created from the extracted mesh data
-        return Mesh(vertices, indices, textures);
+        return textures;
+    }
+
+    // 按三角形顺序把网格拆成多块，每块的顶点数不超过 maxVertices，被多块共用的顶点会复制
+    static void splitMesh(const vector<Vertex>& vertices, const vector<unsigned int>& indices, size_t maxVertices,
+                          vector<vector<Vertex>>& chunkVertices, vector<vector<unsigned int>>& chunkIndices)
+    {
+        const unsigned int UNASSIGNED = 0xFFFFFFFFu;
+        vector<unsigned int> local(vertices.size(), UNASSIGNED);
+        vector<unsigned int> touched;       // 当前块用到的原顶点，换块时据此重置 local
+        maxVertices = std::max<size_t>(maxVertices, 3);
+
+        chunkVertices.emplace_back();
+        chunkIndices.emplace_back();
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            size_t added = 0;
+            for (int k = 0; k < 3; k++) {
+                if (local[indices[t + k]] == UNASSIGNED)
+                    added++;
+            }
+            if (chunkVertices.back().size() + added > maxVertices) {
+                for (unsigned int v : touched)
+                    local[v] = UNASSIGNED;
+                touched.clear();
+                chunkVertices.emplace_back();
+                chunkIndices.emplace_back();
+            }
+            for (int k = 0; k < 3; k++) {
+                unsigned int v = indices[t + k];
+                if (local[v] == UNASSIGNED) {
+                    local[v] = (unsigned int)chunkVertices.back().size();
+                    chunkVertices.back().push_back(vertices[v]);
+                    touched.push_back(v);
+                }
+                chunkIndices.back().push_back(local[v]);
+            }
+        }
     }
 
     // checks all material textures of a given type and loads the textures if they're not loaded yet.
@@ -235,30 +741,29 @@ private:
         {
             aiString str;
             mat->GetTexture(type, i, &str);
-            // check if texture was loaded before and if so, continue to next iteration: skip loading a new texture
-            bool skip = false;
-            for(unsigned int j = 0; j < textures_loaded.size(); j++)
-            {
-                if(std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0)
-                {
-                    textures.push_back(textures_loaded[j]);
-                    skip = true; // a texture with the same filepath has already been loaded, continue to next one. (optimization)
-                    break;
-                }
-            }
-            if(!skip)
-            {   // if texture hasn't been loaded already, load it
-                Texture texture;
-                texture.id = TextureFromFile(str.C_Str(), this->directory);
-                texture.type = typeName;
-                texture.path = str.C_Str();
-                textures.push_back(texture);
-                textures_loaded.push_back(texture);  // store it as texture loaded for entire model, to ensure we won't unnecessary load duplicate textures.
-            }
+            textures.push_back(loadTexture(str.C_Str(), typeName));
         }
         return textures;
     }
 
+    // 按路径加载一张纹理，同一路径只加载一次（返回第一次加载时的记录）
+    Texture loadTexture(const char *path, const string &typeName)
+    {
+        // check if texture was loaded before and if so, skip loading a new texture
+        for(unsigned int j = 0; j < textures_loaded.size(); j++)
+        {
+            if(std::strcmp(textures_loaded[j].path.data(), path) == 0)
+                return textures_loaded[j];
+        }
+        // if texture hasn't been loaded already, load it
+        Texture texture;
+        texture.id = TextureFromFile(path, this->directory);
+        texture.type = typeName;
+        texture.path = path;
+        textures_loaded.push_back(texture);  // store it as texture loaded for entire model, to ensure we won't unnecessary load duplicate textures.
+        return texture;
+    }
+
     // 辅助函数：检查纹理文件名是否表示反射贴图
     bool isReflectionTexture(const string& filename) {
         string lowerFilename = filename;
@@ -295,7 +800,7 @@ unsigned int TextureFromFile(const char *path, const string &directory, bool gam
         else if (nrComponents == 4)
             format = GL_RGBA;
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        GLStateCache::instance().bindTexture(0, GL_TEXTURE_2D, textureID);
         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -0,0 +1,222 @@
+#ifndef POSITION_STREAM_H
+#define POSITION_STREAM_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Vertex.h"
+#include "IndexFormat.h"
+#include "Render/GLStateCache.h"
+
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// 仅含位置的紧凑顶点流与深度 VAO，供深度预渲染与阴影通道使用，每个顶点只拉取 12 字节
+// 着色属性不同但位置相同的顶点（UV 接缝、硬边法线）可以合并，此时深度通道使用自己的索引缓冲，
+// 顶点更少、后变换缓存命中更高；无法合并时直接复用网格的 EBO
+class PositionStream
+{
+public:
+    PositionStream() = default;
+    ~PositionStream() { cleanup(); }
+
+    PositionStream(const PositionStream&) = delete;
+    PositionStream& operator=(const PositionStream&) = delete;
+
+    PositionStream(PositionStream&& other) noexcept
+        : VAO(other.VAO), VBO(other.VBO), EBO(other.EBO)
+        , indexCount(other.indexCount), indexType(other.indexType), positionCount(other.positionCount)
+        , remap_(std::move(other.remap_))
+    {
+        other.VAO = 0;
+        other.VBO = 0;
+        other.EBO = 0;
+    }
+
+    PositionStream& operator=(PositionStream&& other) noexcept
+    {
+        if (this != &other) {
+            cleanup();
+            VAO = other.VAO;
+            VBO = other.VBO;
+            EBO = other.EBO;
+            indexCount = other.indexCount;
+            indexType = other.indexType;
+            positionCount = other.positionCount;
+            remap_ = std::move(other.remap_);
+            other.VAO = 0;
+            other.VBO = 0;
+            other.EBO = 0;
+        }
+        return *this;
+    }
+
+    // 生成位置流；sharedEBO / sharedIndexType 为网格的索引缓冲及其宽度，位置无法合并时直接复用
+    // sharedEBO 为 0（网格位于 GeometryArena 中，没有独立的索引缓冲）时总是上传自己的索引
+    bool build(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, GLuint sharedEBO, GLenum sharedIndexType, bool weldPositions = true)
+    {
+        cleanup();
+        if (vertices.empty() || indices.empty())
+            return false;
+
+        std::vector<glm::vec3> positions;
+        std::vector<unsigned int> remap;
+        if (weldPositions)
+            weld(vertices, positions, remap);
+        bool welded = weldPositions && positions.size() < vertices.size();
+        if (!welded) {
+            positions.resize(vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++)
+                positions[i] = vertices[i].position;
+        }
+
+        GLStateCache& state = GLStateCache::instance();
+        glGenVertexArrays(1, &VAO);
+        state.bindVertexArray(VAO);
+
+        glGenBuffers(1, &VBO);
+        state.bindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_STATIC_DRAW);
+
+        if (welded || sharedEBO == 0) {
+            std::vector<unsigned int> depthIndices(indices.size());
+            for (size_t i = 0; i < indices.size(); i++)
+                depthIndices[i] = welded ? remap[indices[i]] : indices[i];
+            glGenBuffers(1, &EBO);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+            indexType = IndexFormat::upload(depthIndices, positions.size());
+        }
+        else {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sharedEBO);
+            indexType = sharedIndexType;
+        }
+
+        // 位置 (location = 0)，与着色 VAO 的 location 一致，深度着色器可直接复用普通顶点着色器的声明
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        state.bindVertexArray(0);
+
+        indexCount = (GLsizei)indices.size();
+        positionCount = positions.size();
+        if (welded)
+            remap_ = std::move(remap);
+        return true;
+    }
+
+    // 顶点位置变化而拓扑不变时原地更新：沿用 build() 时的合并映射，孤立旧存储后用 glBufferSubData 重新填充
+    // 顶点数变化、或原本合并的顶点不再重合（合并后的位置数会变）时返回 false，由调用方重新 build()
+    bool update(const std::vector<Vertex>& vertices)
+    {
+        if (VAO == 0 || vertices.size() != (remap_.empty() ? positionCount : remap_.size()))
+            return false;
+
+        std::vector<glm::vec3> positions(positionCount);
+        if (remap_.empty()) {
+            for (size_t i = 0; i < vertices.size(); i++)
+                positions[i] = vertices[i].position;
+        }
+        else {
+            std::vector<unsigned char> written(positionCount, 0);
+            for (size_t i = 0; i < vertices.size(); i++) {
+                glm::vec3 position = vertices[i].position + glm::vec3(0.0f);
+                unsigned int slot = remap_[i];
+                if (written[slot] && positions[slot] != position)
+                    return false;
+                positions[slot] = position;
+                written[slot] = 1;
+            }
+        }
+
+        GLsizeiptr size = (GLsizeiptr)(positions.size() * sizeof(glm::vec3));
+        GLStateCache::instance().bindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, positions.data());
+        return true;
+    }
+
+    void cleanup()
+    {
+        GLStateCache& state = GLStateCache::instance();
+        if (EBO) {
+            glDeleteBuffers(1, &EBO);
+            state.bufferDeleted(EBO);
+            EBO = 0;
+        }
+        if (VBO) {
+            glDeleteBuffers(1, &VBO);
+            state.bufferDeleted(VBO);
+            VBO = 0;
+        }
+        if (VAO) {
+            glDeleteVertexArrays(1, &VAO);
+            state.vertexArrayDeleted(VAO);
+            VAO = 0;
+        }
+        indexCount = 0;
+        positionCount = 0;
+        std::vector<unsigned int>().swap(remap_);
+    }
+
+    bool valid() const { return VAO != 0; }
+
+    // 绘制深度通道，调用前需激活深度着色器
+    void render() const
+    {
+        GLStateCache::instance().bindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, indexCount, indexType, 0);
+    }
+
+    // 位置流占用的显存（字节），不含复用的索引缓冲
+    size_t memoryBytes() const
+    {
+        return positionCount * sizeof(glm::vec3) + (EBO ? (size_t)indexCount * IndexFormat::typeSize(indexType) : 0);
+    }
+
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    GLuint EBO = 0;             // 独立的索引缓冲，复用网格 EBO 时为 0
+    GLsizei indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    size_t positionCount = 0;
+
+private:
+    std::vector<unsigned int> remap_;   // 合并时 原顶点 -> 位置流下标，供 update() 复用；未合并时为空
+
+    struct PositionKey {
+        uint32_t x, y, z;
+        bool operator==(const PositionKey& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+
+    struct PositionKeyHash {
+        size_t operator()(const PositionKey& key) const
+        {
+            return ((size_t)key.x * 73856093u) ^ ((size_t)key.y * 19349663u) ^ ((size_t)key.z * 83492791u);
+        }
+    };
+
+    // 按位置的位模式精确合并（不做容差），remap[原顶点] = 位置流中的下标
+    static void weld(const std::vector<Vertex>& vertices, std::vector<glm::vec3>& positions, std::vector<unsigned int>& remap)
+    {
+        std::unordered_map<PositionKey, unsigned int, PositionKeyHash> unique;
+        unique.reserve(vertices.size());
+        remap.resize(vertices.size());
+        positions.clear();
+        positions.reserve(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            glm::vec3 position = vertices[i].position + glm::vec3(0.0f);   // 将 -0.0 归一为 +0.0
+            PositionKey key;
+            std::memcpy(&key.x, &position.x, 4);
+            std::memcpy(&key.y, &position.y, 4);
+            std::memcpy(&key.z, &position.z, 4);
+            auto result = unique.emplace(key, (unsigned int)positions.size());
+            if (result.second)
+                positions.push_back(position);
+            remap[i] = result.first->second;
+        }
+    }
+};
+
+#endif
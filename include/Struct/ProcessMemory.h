@@ -0,0 +1,62 @@
+#ifndef PROCESS_MEMORY_H
+#define PROCESS_MEMORY_H
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+    #include <unistd.h>
+    #include <cstdio>
+#endif
+
+#include <cstddef>
+
+// 进程常驻内存（RSS）查询，用于统计模型加载时的内存占用
+// Windows 使用工作集，Linux 读取 /proc/self/statm 与 getrusage，macOS 只有峰值
+struct ProcessMemory {
+    // 当前常驻内存（字节），无法获取时返回 0
+    static size_t currentResidentBytes()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return (size_t)counters.WorkingSetSize;
+        return 0;
+#elif defined(__linux__)
+        long pages = 0;
+        long resident = 0;
+        FILE* file = std::fopen("/proc/self/statm", "r");
+        if (!file)
+            return 0;
+        if (std::fscanf(file, "%ld %ld", &pages, &resident) != 2)
+            resident = 0;
+        std::fclose(file);
+        return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+#else
+        return 0;
+#endif
+    }
+
+    // 进程启动以来的峰值常驻内存（字节）
+    static size_t peakResidentBytes()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return (size_t)counters.PeakWorkingSetSize;
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+    #ifdef __APPLE__
+        return (size_t)usage.ru_maxrss;             // macOS 以字节为单位
+    #else
+        return (size_t)usage.ru_maxrss * 1024;      // Linux 以 KB 为单位
+    #endif
+#endif
+    }
+};
+
+#endif
@@ -14,17 +14,22 @@ public:
     float getRadius() const { return radius_; }
     int getSegments() const { return segments_; }
     
-    // 主要接口：设置球半径，并会调用相应接口进行绘制
+    // 主要接口：设置球半径
+    // 网格始终是单位球，只在首次调用时生成；半径作为模型矩阵中的均匀缩放，法线与纹理坐标不受影响，
+    // 因此逐帧改变半径不需要重新生成或上传顶点
     void setRadius(float radius) {
         radius_ = radius;
-        generateGeometry();
+        setShapeScale(glm::vec3(radius_));
+        if (getMesh().vertexCount == 0) {
+            generateGeometry();
+        }
     }
     
 private:
     float radius_;     // 球体半径
     int segments_;     // 球体分段数（控制精度）
     
-    // 生成球体几何
+    // 生成单位球几何（半径由 setShapeScale 施加）
     void generateGeometry() {
         clear();
         
@@ -44,11 +49,11 @@ private:
                 float cosYaw = glm::cos(yaw);
                 float sinYaw = glm::sin(yaw);
                 
-                // 计算顶点位置（球心在原点）
+                // 计算顶点位置（球心在原点，单位半径）
                 glm::vec3 position(
-                    radius_ * cosPitch * cosYaw,    // x
-                    radius_ * sinPitch,             // y
-                    radius_ * cosPitch * sinYaw     // z
+                    cosPitch * cosYaw,    // x
+                    sinPitch,             // y
+                    cosPitch * sinYaw     // z
                 );
                 
                 // 法线就是归一化的位置向量（因为球心在原点）
@@ -79,6 +84,8 @@ private:
         }
         
         // 初始化缓冲区（如果已存在则更新）
+        optimizeMesh("GEOMETRY::SPHERE");
+        generateTangents("GEOMETRY::SPHERE");
         if (!initBuffers()) {
             std::cout << "Error: Failed to init Sphere's Buffers" << std::endl;
         }
@@ -0,0 +1,279 @@
+#ifndef TANGENT_GENERATOR_H
+#define TANGENT_GENERATOR_H
+
+#include "Vertex.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define TANGENT_GENERATOR_SSE 1
+    #include <emmintrin.h>
+#endif
+
+// 切线空间生成，结果与 MikkTSpace 一致：
+//     1. 每个三角形：切线 = dP/du（按 UV 面积符号校正方向），UV 面积为正时保持手性，为负时为镜像
+//     2. 每个角：三角形切线投影到该顶点法线的切平面并归一化，按该角在切平面上的夹角加权
+//     3. 每个顶点：加权和归一化为切线，手性取加权多数，副切线 = 手性 * cross(normal, tangent)
+// 与 MikkTSpace 的差别：MikkTSpace 会把手性不同或不共享切线的面拆成不同的顶点，这里不增加顶点，
+// 同一个顶点上手性冲突的面按夹角权重取多数（UV 镜像接缝处的顶点通常本来就是分开的，不受影响）
+// 第 2 步每次处理 4 个三角形（SSE2，acos 用 7 次多项式近似，遍历 [-1, 1] 内全部 float 测得与 std::acos 的最大差为 4.8e-7 弧度），
+// 三角形数超过 PARALLEL_TRIANGLES 时第 2、3 步在线程池中分块并行
+class TangentGenerator
+{
+public:
+    static const size_t PARALLEL_TRIANGLES = 16384;
+    static const size_t GRAIN_TRIANGLES = 4096;     // 角点计算每块的三角形数
+    static const size_t GRAIN_VERTICES = 4096;      // 逐顶点正交化每块的顶点数
+
+    struct Report {
+        size_t triangles = 0;
+        size_t vertices = 0;
+        size_t skippedTriangles = 0;    // UV 或位置退化，不参与加权
+        size_t threads = 1;
+        double milliseconds = 0.0;
+
+        void print(const std::string& label) const
+        {
+            std::cout << "TANGENT_GENERATOR:: " << label
+                      << " triangles: " << triangles << ", vertices: " << vertices
+                      << ", degenerate: " << skippedTriangles
+                      << ", " << milliseconds << " ms (" << threads << " threads)" << std::endl;
+        }
+    };
+
+    // 写入每个顶点的 tangent 与 bitangent，需要 position、normal（单位长度）与 texCoord
+    // pool 为空或三角形数不超过 PARALLEL_TRIANGLES 时在调用线程中完成
+    static Report generate(std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                           ThreadPool* pool = &ThreadPool::instance())
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        Report report;
+        report.triangles = indices.size() / 3;
+        report.vertices = vertices.size();
+        bool parallel = pool && pool->threadCount() > 0 && report.triangles > PARALLEL_TRIANGLES;
+        report.threads = parallel ? pool->threadCount() + 1 : 1;
+
+        // 每个角 4 个 float：加权后的切线 xyz 与加权手性
+        std::vector<float> corners(report.triangles * 12);
+        auto cornerPass = [&](size_t begin, size_t end) {
+            computeCorners(vertices.data(), indices.data(), begin, end, corners.data());
+        };
+        if (parallel)
+            pool->parallelFor(report.triangles, GRAIN_TRIANGLES, cornerPass);
+        else
+            cornerPass(0, report.triangles);
+
+        // 累加到顶点：每个顶点可能被多个块的三角形引用，串行进行
+        std::vector<float> sums(vertices.size() * 4, 0.0f);
+        for (size_t t = 0; t < report.triangles; t++) {
+            const float* corner = &corners[t * 12];
+            if (corner[3] == 0.0f && corner[7] == 0.0f && corner[11] == 0.0f) {
+                report.skippedTriangles++;
+                continue;
+            }
+            for (int k = 0; k < 3; k++) {
+                float* sum = &sums[(size_t)indices[t * 3 + k] * 4];
+                for (int i = 0; i < 4; i++)
+                    sum[i] += corner[k * 4 + i];
+            }
+        }
+
+        auto vertexPass = [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; v++)
+                resolveVertex(vertices[v], &sums[v * 4]);
+        };
+        if (parallel)
+            pool->parallelFor(vertices.size(), GRAIN_VERTICES, vertexPass);
+        else
+            vertexPass(0, vertices.size());
+
+        report.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        return report;
+    }
+
+private:
+    // acos 的多项式近似（Abramowitz & Stegun 4.4.46），x 需在 [-1, 1] 内
+    static float acosApprox(float x)
+    {
+        float a = std::fabs(x);
+        float p = -0.0012624911f;
+        p = p * a + 0.0066700901f;
+        p = p * a - 0.0170881256f;
+        p = p * a + 0.0308918810f;
+        p = p * a - 0.0501743046f;
+        p = p * a + 0.0889789874f;
+        p = p * a - 0.2145988016f;
+        p = p * a + 1.5707963050f;
+        float r = std::sqrt(1.0f - a) * p;
+        return x < 0.0f ? 3.14159265f - r : r;
+    }
+
+    // 三角形 [begin, end) 的角：先成组每次 4 个，剩余的逐个处理
+    static void computeCorners(const Vertex* vertices, const unsigned int* indices, size_t begin, size_t end, float* corners)
+    {
+        size_t t = begin;
+#ifdef TANGENT_GENERATOR_SSE
+        for (; t + 4 <= end; t += 4)
+            computeCorners4(vertices, indices + t * 3, corners + t * 12);
+#endif
+        for (; t < end; t++)
+            computeCorners1(vertices, indices + t * 3, corners + t * 12);
+    }
+
+    static void computeCorners1(const Vertex* vertices, const unsigned int* triangle, float* out)
+    {
+        const Vertex* corner[3] = { &vertices[triangle[0]], &vertices[triangle[1]], &vertices[triangle[2]] };
+        glm::vec3 d1 = corner[1]->position - corner[0]->position;
+        glm::vec3 d2 = corner[2]->position - corner[0]->position;
+        glm::vec2 st1 = corner[1]->texCoord - corner[0]->texCoord;
+        glm::vec2 st2 = corner[2]->texCoord - corner[0]->texCoord;
+        float area = st1.x * st2.y - st1.y * st2.x;
+        float orientation = area > 0.0f ? 1.0f : -1.0f;
+        glm::vec3 os = (d1 * st2.y - d2 * st1.y) * orientation;
+        float length = glm::length(os);
+        bool valid = std::fabs(area) > 0.0f && length > 0.0f;
+
+        for (int k = 0; k < 3; k++) {
+            float* o = out + k * 4;
+            if (!valid) {
+                o[0] = o[1] = o[2] = o[3] = 0.0f;
+                continue;
+            }
+            const glm::vec3& n = corner[k]->normal;
+            glm::vec3 tangent = project(os * (1.0f / length), n);
+            glm::vec3 e1 = project(corner[(k + 2) % 3]->position - corner[k]->position, n);
+            glm::vec3 e2 = project(corner[(k + 1) % 3]->position - corner[k]->position, n);
+            float cosine = std::min(std::max(glm::dot(e1, e2), -1.0f), 1.0f);
+            float angle = acosApprox(cosine);
+            o[0] = tangent.x * angle;
+            o[1] = tangent.y * angle;
+            o[2] = tangent.z * angle;
+            o[3] = orientation * angle;
+        }
+    }
+
+    // v 投影到法线 n 的切平面并归一化，长度为 0 时保持为 0（与 MikkTSpace 的 NotZero 判断一致）
+    static glm::vec3 project(const glm::vec3& v, const glm::vec3& n)
+    {
+        glm::vec3 p = v - n * glm::dot(n, v);
+        float length = glm::length(p);
+        return length > 0.0f ? p * (1.0f / length) : p;
+    }
+
+    static void resolveVertex(Vertex& vertex, const float* sum)
+    {
+        const glm::vec3& n = vertex.normal;
+        glm::vec3 tangent = project(glm::vec3(sum[0], sum[1], sum[2]), n);
+        if (glm::dot(tangent, tangent) == 0.0f) {
+            // 没有有效三角形：取与法线垂直的任意方向
+            glm::vec3 axis = std::fabs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+            tangent = project(axis, n);
+        }
+        float handedness = sum[3] < 0.0f ? -1.0f : 1.0f;
+        vertex.tangent = tangent;
+        vertex.bitangent = glm::cross(n, tangent) * handedness;
+    }
+
+#ifdef TANGENT_GENERATOR_SSE
+    struct Vec4x3 {
+        __m128 x, y, z;
+    };
+
+    static Vec4x3 sub(const Vec4x3& a, const Vec4x3& b) { return { _mm_sub_ps(a.x, b.x), _mm_sub_ps(a.y, b.y), _mm_sub_ps(a.z, b.z) }; }
+    static Vec4x3 scale(const Vec4x3& a, __m128 s) { return { _mm_mul_ps(a.x, s), _mm_mul_ps(a.y, s), _mm_mul_ps(a.z, s) }; }
+
+    static __m128 dot(const Vec4x3& a, const Vec4x3& b)
+    {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+    }
+
+    // 长度为 0 的通道保持为 0
+    static Vec4x3 normalize(const Vec4x3& v)
+    {
+        __m128 lengthSquared = dot(v, v);
+        __m128 nonZero = _mm_cmpgt_ps(lengthSquared, _mm_setzero_ps());
+        __m128 inverse = _mm_and_ps(nonZero, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_max_ps(lengthSquared, _mm_set1_ps(1e-38f)))));
+        return scale(v, inverse);
+    }
+
+    static Vec4x3 project(const Vec4x3& v, const Vec4x3& n)
+    {
+        return normalize(sub(v, scale(n, dot(n, v))));
+    }
+
+    static __m128 acos4(__m128 x)
+    {
+        __m128 signBit = _mm_set1_ps(-0.0f);
+        __m128 a = _mm_andnot_ps(signBit, x);
+        __m128 p = _mm_set1_ps(-0.0012624911f);
+        p = _mm_add_ps(_mm_mul_ps(p, a), _mm_set1_ps(0.0066700901f));
+        p = _mm_add_ps(_mm_mul_ps(p, a), _mm_set1_ps(-0.0170881256f));
+        p = _mm_add_ps(_mm_mul_ps(p, a), _mm_set1_ps(0.0308918810f));
+        p = _mm_add_ps(_mm_mul_ps(p, a), _mm_set1_ps(-0.0501743046f));
+        p = _mm_add_ps(_mm_mul_ps(p, a), _mm_set1_ps(0.0889789874f));
+        p = _mm_add_ps(_mm_mul_ps(p, a), _mm_set1_ps(-0.2145988016f));
+        p = _mm_add_ps(_mm_mul_ps(p, a), _mm_set1_ps(1.5707963050f));
+        __m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), a)), p);
+        __m128 negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+        return _mm_or_ps(_mm_and_ps(negative, _mm_sub_ps(_mm_set1_ps(3.14159265f), r)), _mm_andnot_ps(negative, r));
+    }
+
+    // 4 个三角形：顶点属性转置为 SoA 后与 computeCorners1 做同样的计算
+    static void computeCorners4(const Vertex* vertices, const unsigned int* triangles, float* out)
+    {
+        alignas(16) float px[3][4], py[3][4], pz[3][4], nx[3][4], ny[3][4], nz[3][4], u[3][4], v[3][4];
+        for (int lane = 0; lane < 4; lane++) {
+            for (int k = 0; k < 3; k++) {
+                const Vertex& vertex = vertices[triangles[lane * 3 + k]];
+                px[k][lane] = vertex.position.x; py[k][lane] = vertex.position.y; pz[k][lane] = vertex.position.z;
+                nx[k][lane] = vertex.normal.x;   ny[k][lane] = vertex.normal.y;   nz[k][lane] = vertex.normal.z;
+                u[k][lane] = vertex.texCoord.x;  v[k][lane] = vertex.texCoord.y;
+            }
+        }
+        Vec4x3 p[3], n[3];
+        for (int k = 0; k < 3; k++) {
+            p[k] = { _mm_load_ps(px[k]), _mm_load_ps(py[k]), _mm_load_ps(pz[k]) };
+            n[k] = { _mm_load_ps(nx[k]), _mm_load_ps(ny[k]), _mm_load_ps(nz[k]) };
+        }
+        __m128 s1 = _mm_sub_ps(_mm_load_ps(u[1]), _mm_load_ps(u[0]));
+        __m128 t1 = _mm_sub_ps(_mm_load_ps(v[1]), _mm_load_ps(v[0]));
+        __m128 s2 = _mm_sub_ps(_mm_load_ps(u[2]), _mm_load_ps(u[0]));
+        __m128 t2 = _mm_sub_ps(_mm_load_ps(v[2]), _mm_load_ps(v[0]));
+
+        __m128 zero = _mm_setzero_ps();
+        __m128 area = _mm_sub_ps(_mm_mul_ps(s1, t2), _mm_mul_ps(t1, s2));
+        __m128 positive = _mm_cmpgt_ps(area, zero);
+        __m128 orientation = _mm_or_ps(_mm_and_ps(positive, _mm_set1_ps(1.0f)), _mm_andnot_ps(positive, _mm_set1_ps(-1.0f)));
+        Vec4x3 d1 = sub(p[1], p[0]);
+        Vec4x3 d2 = sub(p[2], p[0]);
+        Vec4x3 os = scale(sub(scale(d1, t2), scale(d2, t1)), orientation);
+        __m128 valid = _mm_and_ps(_mm_cmpneq_ps(area, zero), _mm_cmpgt_ps(dot(os, os), zero));
+        os = normalize(os);
+
+        alignas(16) float result[3][4][4];
+        for (int k = 0; k < 3; k++) {
+            Vec4x3 tangent = project(os, n[k]);
+            Vec4x3 e1 = project(sub(p[(k + 2) % 3], p[k]), n[k]);
+            Vec4x3 e2 = project(sub(p[(k + 1) % 3], p[k]), n[k]);
+            __m128 cosine = _mm_min_ps(_mm_max_ps(dot(e1, e2), _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+            __m128 angle = _mm_and_ps(valid, acos4(cosine));
+            _mm_store_ps(result[k][0], _mm_mul_ps(tangent.x, angle));
+            _mm_store_ps(result[k][1], _mm_mul_ps(tangent.y, angle));
+            _mm_store_ps(result[k][2], _mm_mul_ps(tangent.z, angle));
+            _mm_store_ps(result[k][3], _mm_mul_ps(orientation, angle));
+        }
+        for (int lane = 0; lane < 4; lane++)
+            for (int k = 0; k < 3; k++)
+                for (int i = 0; i < 4; i++)
+                    out[lane * 12 + k * 4 + i] = result[k][i][lane];
+    }
+#endif
+};
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定数量工作线程的线程池（CPU 侧的批量计算使用，如动画姿态求值）
+// parallelFor 把 [0, count) 按 grain 切块，调用线程也参与执行，全部完成后才返回；
+// 工作函数内不要访问 GL，GL 上下文只属于主线程
+// 线程数默认为硬件线程数 - 1（留出主线程），单核时不创建工作线程，parallelFor 退化为串行
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t threadCount = defaultThreadCount())
+    {
+        workers_.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++)
+            workers_.emplace_back([this]() { workerLoop(); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wakeup_.notify_all();
+        for (std::thread& worker : workers_)
+            worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 全局共享的线程池，首次使用时创建
+    static ThreadPool& instance()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    static size_t defaultThreadCount()
+    {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 0;
+    }
+
+    size_t threadCount() const { return workers_.size(); }
+
+    // 提交单个任务，返回其结果的 future
+    template <typename F>
+    auto submit(F&& task) -> std::future<decltype(task())>
+    {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        if (workers_.empty()) {
+            (*packaged)();
+            return future;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace_back([packaged]() { (*packaged)(); });
+        }
+        wakeup_.notify_one();
+        return future;
+    }
+
+    // 并行执行 body(begin, end)，每块至多 grain 个元素；块通过原子计数领取，负载不均时自动平衡
+    template <typename F>
+    void parallelFor(size_t count, size_t grain, F&& body)
+    {
+        if (count == 0)
+            return;
+        grain = std::max<size_t>(grain, 1);
+        size_t chunks = (count + grain - 1) / grain;
+        if (workers_.empty() || chunks == 1) {
+            body((size_t)0, count);
+            return;
+        }
+
+        struct Job {
+            std::atomic<size_t> next{ 0 };
+            std::atomic<size_t> done{ 0 };
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+        auto job = std::make_shared<Job>();
+        auto run = [job, count, grain, chunks, &body]() {
+            size_t completed = 0;
+            for (size_t chunk = job->next++; chunk < chunks; chunk = job->next++) {
+                size_t begin = chunk * grain;
+                body(begin, std::min(begin + grain, count));
+                completed++;
+            }
+            if (completed > 0 && job->done.fetch_add(completed) + completed == chunks) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->finished.notify_all();
+            }
+        };
+
+        // 调用线程也算一个执行者，只唤醒需要的工作线程
+        size_t helpers = std::min(workers_.size(), chunks - 1);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < helpers; i++)
+                tasks_.emplace_back(run);
+        }
+        if (helpers == workers_.size())
+            wakeup_.notify_all();
+        else
+            for (size_t i = 0; i < helpers; i++)
+                wakeup_.notify_one();
+
+        run();
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->finished.wait(lock, [&job, chunks]() { return job->done.load() == chunks; });
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    bool stopping_ = false;
+
+    void workerLoop()
+    {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wakeup_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+                if (stopping_ && tasks_.empty())
+                    return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+};
+
+#endif
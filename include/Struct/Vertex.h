@@ -14,10 +14,10 @@ struct Vertex {
     glm::vec2 texCoord;     // 纹理坐标（u, v）
     glm::vec3 color;        // 顶点颜色
         
-    glm::vec3 tangent;      // tangent
-    glm::vec3 bitangent;    // bitangent
-	int m_BoneIDs[MAX_BONE_INFLUENCE];  // bone indexes which will influence this vertex
-	float m_Weights[MAX_BONE_INFLUENCE];// weights from each bone
+    glm::vec3 tangent = glm::vec3(0.0f);      // tangent
+    glm::vec3 bitangent = glm::vec3(0.0f);    // bitangent
+	int m_BoneIDs[MAX_BONE_INFLUENCE] = {};   // bone indexes which will influence this vertex
+	float m_Weights[MAX_BONE_INFLUENCE] = {}; // weights from each bone
     
     // 默认构造函数
     Vertex() : position(0.0f), normal(0.0f, 0.0f, 1.0f), texCoord(0.0f), color(0.0f) {}
@@ -0,0 +1,216 @@
+#ifndef VERTEX_LAYOUT_H
+#define VERTEX_LAYOUT_H
+
+#include <glad/glad.h>
+
+#include "Vertex.h"
+#include "VertexPacking.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// 顶点布局描述：网格实际拥有哪些属性，以及每个属性在交错顶点缓冲中的类型与偏移
+// 由导入或生成时得到的属性掩码与 VertexFormat 计算，只打包、上传并启用掩码中的属性
+// 属性序号即着色器中的 location；未启用的属性由 GL 提供常量默认值 (0, 0, 0, 1)
+struct VertexLayout {
+    enum Attribute {
+        POSITION,       // location = 0
+        NORMAL,         // location = 1
+        TEXCOORD,       // location = 2
+        COLOR,          // location = 3
+        TANGENT,        // location = 4
+        BITANGENT,      // location = 5
+        BONE_IDS,       // location = 6
+        WEIGHTS,        // location = 7
+        ATTRIBUTE_COUNT
+    };
+
+    enum Mask : uint32_t {
+        POSITION_BIT  = 1u << POSITION,
+        NORMAL_BIT    = 1u << NORMAL,
+        TEXCOORD_BIT  = 1u << TEXCOORD,
+        COLOR_BIT     = 1u << COLOR,
+        TANGENT_BIT   = 1u << TANGENT,
+        BITANGENT_BIT = 1u << BITANGENT,
+        BONE_IDS_BIT  = 1u << BONE_IDS,
+        WEIGHTS_BIT   = 1u << WEIGHTS,
+        ALL_BITS      = (1u << ATTRIBUTE_COUNT) - 1u
+    };
+
+    struct AttributeDesc {
+        bool enabled = false;
+        GLint size = 0;                     // 分量数
+        GLenum type = 0;
+        GLboolean normalized = GL_FALSE;
+        bool integer = false;               // 使用 glVertexAttribIPointer
+        GLuint offset = 0;
+        GLuint bytes = 0;
+    };
+
+    uint32_t mask = 0;
+    VertexFormat format = VertexFormat::FULL;
+    GLsizei stride = 0;
+    AttributeDesc attributes[ATTRIBUTE_COUNT];
+
+    // 位置总是存在；量化格式下副切线只以符号形式存入切线的 w 分量
+    static VertexLayout create(uint32_t mask, VertexFormat format)
+    {
+        VertexLayout layout;
+        layout.mask = (mask | POSITION_BIT) & ALL_BITS;
+        layout.format = format;
+
+        bool packed = format == VertexFormat::PACKED;
+        layout.add(POSITION, 3, GL_FLOAT, GL_FALSE, false, 12);
+        if (packed) {
+            layout.add(NORMAL,   4, GL_INT_2_10_10_10_REV, GL_TRUE, false, 4);
+            layout.add(TEXCOORD, 2, GL_HALF_FLOAT, GL_FALSE, false, 4);
+            layout.add(COLOR,    4, GL_UNSIGNED_BYTE, GL_TRUE, false, 4);
+            layout.add(TANGENT,  4, GL_INT_2_10_10_10_REV, GL_TRUE, false, 4);
+            layout.add(BONE_IDS, 4, GL_UNSIGNED_BYTE, GL_FALSE, true, 4);
+            layout.add(WEIGHTS,  4, GL_UNSIGNED_BYTE, GL_TRUE, false, 4);
+        }
+        else {
+            layout.add(NORMAL,    3, GL_FLOAT, GL_FALSE, false, 12);
+            layout.add(TEXCOORD,  2, GL_FLOAT, GL_FALSE, false, 8);
+            layout.add(COLOR,     3, GL_FLOAT, GL_FALSE, false, 12);
+            layout.add(TANGENT,   3, GL_FLOAT, GL_FALSE, false, 12);
+            layout.add(BITANGENT, 3, GL_FLOAT, GL_FALSE, false, 12);
+            layout.add(BONE_IDS,  4, GL_INT, GL_FALSE, true, 16);
+            layout.add(WEIGHTS,   4, GL_FLOAT, GL_FALSE, false, 16);
+        }
+        return layout;
+    }
+
+    bool has(Attribute attribute) const { return attributes[attribute].enabled; }
+
+    // 按布局把顶点打包为交错数据；量化格式下骨骼索引超出 UINT8 范围时返回 false
+    bool pack(const std::vector<Vertex>& vertices, std::vector<unsigned char>& data) const
+    {
+        // 完整格式且拥有全部属性时布局与 Vertex 相同，直接拷贝
+        if (format == VertexFormat::FULL && mask == ALL_BITS && stride == (GLsizei)sizeof(Vertex)) {
+            const unsigned char* begin = reinterpret_cast<const unsigned char*>(vertices.data());
+            data.assign(begin, begin + vertices.size() * sizeof(Vertex));
+            return true;
+        }
+
+        data.assign(vertices.size() * stride, 0);
+        bool inRange = true;
+        unsigned char* out = data.data();
+        for (const Vertex& vertex : vertices) {
+            for (int a = 0; a < ATTRIBUTE_COUNT; a++) {
+                const AttributeDesc& desc = attributes[a];
+                if (desc.enabled)
+                    inRange = writeAttribute((Attribute)a, vertex, out + desc.offset) && inRange;
+            }
+            out += stride;
+        }
+        return inRange;
+    }
+
+    // 设置当前绑定 VAO 的属性指针（调用前需绑定 VAO 与 GL_ARRAY_BUFFER）
+    void apply() const
+    {
+        for (GLuint a = 0; a < ATTRIBUTE_COUNT; a++) {
+            const AttributeDesc& desc = attributes[a];
+            if (!desc.enabled) {
+                glDisableVertexAttribArray(a);
+                continue;
+            }
+            if (desc.integer)
+                glVertexAttribIPointer(a, desc.size, desc.type, stride, (void*)(size_t)desc.offset);
+            else
+                glVertexAttribPointer(a, desc.size, desc.type, desc.normalized, stride, (void*)(size_t)desc.offset);
+            glEnableVertexAttribArray(a);
+        }
+    }
+
+private:
+    void add(Attribute attribute, GLint size, GLenum type, GLboolean normalized, bool integer, GLuint bytes)
+    {
+        if ((mask & (1u << attribute)) == 0)
+            return;
+        AttributeDesc& desc = attributes[attribute];
+        desc.enabled = true;
+        desc.size = size;
+        desc.type = type;
+        desc.normalized = normalized;
+        desc.integer = integer;
+        desc.offset = (GLuint)stride;
+        desc.bytes = bytes;
+        stride += bytes;
+    }
+
+    bool writeAttribute(Attribute attribute, const Vertex& vertex, unsigned char* out) const
+    {
+        if (format == VertexFormat::FULL) {
+            switch (attribute) {
+                case POSITION:  std::memcpy(out, &vertex.position, 12); break;
+                case NORMAL:    std::memcpy(out, &vertex.normal, 12); break;
+                case TEXCOORD:  std::memcpy(out, &vertex.texCoord, 8); break;
+                case COLOR:     std::memcpy(out, &vertex.color, 12); break;
+                case TANGENT:   std::memcpy(out, &vertex.tangent, 12); break;
+                case BITANGENT: std::memcpy(out, &vertex.bitangent, 12); break;
+                case BONE_IDS:  std::memcpy(out, vertex.m_BoneIDs, 16); break;
+                case WEIGHTS:   std::memcpy(out, vertex.m_Weights, 16); break;
+                default: break;
+            }
+            return true;
+        }
+
+        switch (attribute) {
+            case POSITION:
+                std::memcpy(out, &vertex.position, 12);
+                break;
+            case NORMAL: {
+                glm::vec3 normal = VertexPacking::safeNormalize(vertex.normal, glm::vec3(0.0f, 0.0f, 1.0f));
+                uint32_t packed = VertexPacking::packSnorm1010102(normal, 0.0f);
+                std::memcpy(out, &packed, 4);
+                break;
+            }
+            case TEXCOORD: {
+                uint16_t packed[2] = { VertexPacking::floatToHalf(vertex.texCoord.x), VertexPacking::floatToHalf(vertex.texCoord.y) };
+                std::memcpy(out, packed, 4);
+                break;
+            }
+            case COLOR:
+                out[0] = VertexPacking::packUnorm8(vertex.color.x);
+                out[1] = VertexPacking::packUnorm8(vertex.color.y);
+                out[2] = VertexPacking::packUnorm8(vertex.color.z);
+                out[3] = 255;
+                break;
+            case TANGENT: {
+                // w 为副切线符号（+1 / -1），着色器中用 cross(normal, tangent.xyz) * tangent.w 重建副切线
+                glm::vec3 normal = VertexPacking::safeNormalize(vertex.normal, glm::vec3(0.0f, 0.0f, 1.0f));
+                glm::vec3 tangent = VertexPacking::safeNormalize(vertex.tangent, glm::vec3(1.0f, 0.0f, 0.0f));
+                float handedness = glm::dot(glm::cross(normal, tangent), vertex.bitangent) < 0.0f ? -1.0f : 1.0f;
+                uint32_t packed = VertexPacking::packSnorm1010102(tangent, handedness);
+                std::memcpy(out, &packed, 4);
+                break;
+            }
+            case BONE_IDS: {
+                bool inRange = true;
+                for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+                    int id = vertex.m_BoneIDs[i];
+                    if (id > 255) {
+                        inRange = false;
+                        id = 0;
+                    }
+                    else if (id < 0) {
+                        id = 0;     // -1 表示无骨骼，对应权重为 0
+                    }
+                    out[i] = (uint8_t)id;
+                }
+                return inRange;
+            }
+            case WEIGHTS:
+                VertexPacking::packWeights(vertex.m_Weights, out);
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef VERTEX_PACKING_H
+#define VERTEX_PACKING_H
+
+#include "Vertex.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// 顶点在 GPU 上的存储格式
+enum class VertexFormat {
+    FULL,       // Vertex 原样上传（全部为 float / int）
+    PACKED      // 量化格式：法线/切线 10:10:10:2，UV 半精度，颜色与权重 UNORM8，骨骼索引 UINT8
+};
+
+// 顶点属性量化工具，供 VertexLayout 在 VertexFormat::PACKED 下打包顶点数据
+struct VertexPacking {
+    static glm::vec3 safeNormalize(const glm::vec3& v, const glm::vec3& fallback)
+    {
+        float length = glm::length(v);
+        if (!(length > 1e-8f))
+            return fallback;
+        return v / length;
+    }
+
+    // xyz 为 [-1, 1] 的 10 位有符号归一化值，w 为 2 位有符号值（-1 / 0 / 1）
+    static uint32_t packSnorm1010102(const glm::vec3& v, float w)
+    {
+        auto snorm10 = [](float value) -> uint32_t {
+            int q = (int)std::lround(std::max(-1.0f, std::min(1.0f, value)) * 511.0f);
+            return (uint32_t)q & 0x3FFu;
+        };
+        uint32_t sw = (uint32_t)((int)std::lround(std::max(-1.0f, std::min(1.0f, w)))) & 0x3u;
+        return snorm10(v.x) | (snorm10(v.y) << 10) | (snorm10(v.z) << 20) | (sw << 30);
+    }
+
+    static glm::vec4 unpackSnorm1010102(uint32_t packed)
+    {
+        auto snorm10 = [](uint32_t bits) -> float {
+            int value = (int)(bits & 0x3FFu);
+            if (value & 0x200)
+                value -= 0x400;
+            return std::max(-1.0f, value / 511.0f);
+        };
+        int w = (int)(packed >> 30);
+        if (w & 0x2)
+            w -= 0x4;
+        return glm::vec4(snorm10(packed), snorm10(packed >> 10), snorm10(packed >> 20), (float)w);
+    }
+
+    static uint8_t packUnorm8(float value)
+    {
+        return (uint8_t)std::lround(std::max(0.0f, std::min(1.0f, value)) * 255.0f);
+    }
+
+    // IEEE 754 半精度，就近舍入，溢出为无穷，过小的值转为非规格化数或 0
+    static uint16_t floatToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        uint32_t sign = (bits >> 16) & 0x8000u;
+        uint32_t mantissa = bits & 0x7FFFFFu;
+        int exponent = (int)((bits >> 23) & 0xFFu);
+
+        if (exponent == 0xFF)                                   // Inf / NaN
+            return (uint16_t)(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+
+        exponent = exponent - 127 + 15;
+        if (exponent >= 0x1F)                                   // 溢出
+            return (uint16_t)(sign | 0x7C00u);
+        if (exponent <= 0) {                                    // 非规格化数
+            if (exponent < -10)
+                return (uint16_t)sign;
+            mantissa |= 0x800000u;
+            uint32_t shift = (uint32_t)(14 - exponent);
+            uint32_t half = mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1u);
+            uint32_t halfway = 1u << (shift - 1u);
+            if (remainder > halfway || (remainder == halfway && (half & 1u)))
+                half++;
+            return (uint16_t)(sign | half);
+        }
+
+        uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+        uint32_t remainder = mantissa & 0x1FFFu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+            half++;                                             // 进位可能溢出到指数，结果仍然正确
+        return (uint16_t)half;
+    }
+
+    static float halfToFloat(uint16_t half)
+    {
+        uint32_t sign = (uint32_t)(half & 0x8000u) << 16;
+        uint32_t exponent = (half >> 10) & 0x1Fu;
+        uint32_t mantissa = half & 0x3FFu;
+        uint32_t bits;
+        if (exponent == 0) {
+            if (mantissa == 0) {
+                bits = sign;
+            } else {
+                // 非规格化数：规格化后再转换
+                exponent = 127 - 15 + 1;
+                while ((mantissa & 0x400u) == 0) {
+                    mantissa <<= 1;
+                    exponent--;
+                }
+                mantissa &= 0x3FFu;
+                bits = sign | (exponent << 23) | (mantissa << 13);
+            }
+        } else if (exponent == 0x1F) {
+            bits = sign | 0x7F800000u | (mantissa << 13);
+        } else {
+            bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+        }
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // 权重量化为 UNORM8，舍入误差补到最大的权重上，保证总和不变
+    static void packWeights(const float* weights, uint8_t* packed)
+    {
+        float sum = 0.0f;
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+            sum += std::max(0.0f, weights[i]);
+        if (sum <= 0.0f) {
+            std::fill(packed, packed + MAX_BONE_INFLUENCE, (uint8_t)0);
+            return;
+        }
+
+        int total = 0;
+        int largest = 0;
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+            packed[i] = packUnorm8(std::max(0.0f, weights[i]) / sum);
+            total += packed[i];
+            if (packed[i] > packed[largest])
+                largest = i;
+        }
+        packed[largest] = (uint8_t)std::max(0, std::min(255, packed[largest] + 255 - total));
+    }
+};
+
+#endif
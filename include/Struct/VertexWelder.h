@@ -0,0 +1,163 @@
+#ifndef VERTEX_WELDER_H
+#define VERTEX_WELDER_H
+
+#include "Vertex.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 顶点焊接：合并所有属性都相同的重复顶点，并改写索引
+// 每个顶点的全部属性（位置、法线、纹理坐标、颜色、切线、副切线、骨骼索引与权重）组成一个键，
+// 用开放寻址哈希表查找首次出现的相同键，整体为线性时间
+// epsilon = 0 时按位模式精确比较（-0.0 与 +0.0 视为相同），结果与原网格完全等价；
+// epsilon > 0 时浮点属性先量化为 round(v / epsilon) 再比较，合并后保留第一次出现的顶点
+// 注意：量化按格子划分，相差小于 epsilon 但落在格子两侧的值不会合并
+class VertexWelder
+{
+public:
+    static const size_t KEY_WORDS = 3 + 3 + 2 + 3 + 3 + 3 + MAX_BONE_INFLUENCE + MAX_BONE_INFLUENCE;
+
+    struct Report {
+        size_t before = 0;
+        size_t after = 0;
+
+        void accumulate(const Report& other)
+        {
+            before += other.before;
+            after  += other.after;
+        }
+
+        float reduction() const { return before ? 1.0f - (float)after / before : 0.0f; }
+
+        void print(const std::string& label) const
+        {
+            std::cout << "VERTEX_WELDER:: " << label
+                      << " vertices: " << before << " -> " << after
+                      << " (-" << 100.0f * reduction() << "%)" << std::endl;
+        }
+    };
+
+    // 焊接并改写索引，顶点按首次出现顺序保留
+    static Report weld(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, float epsilon = 0.0f)
+    {
+        Report report;
+        report.before = vertices.size();
+        std::vector<unsigned int> remap;
+        size_t unique = buildRemap(vertices, remap, epsilon);
+        report.after = unique;
+        if (unique == vertices.size())
+            return report;
+
+        for (unsigned int& index : indices)
+            index = remap[index];
+        // 首次出现的顶点编号依次递增且不大于原下标，原地前移不会覆盖尚未读取的顶点
+        size_t next = 0;
+        for (size_t i = 0; i < vertices.size(); i++) {
+            if (remap[i] != next)
+                continue;
+            if (next != i)
+                vertices[next] = vertices[i];
+            next++;
+        }
+        vertices.resize(unique);
+        return report;
+    }
+
+    // remap[原顶点] = 焊接后的下标（按首次出现顺序编号），返回唯一顶点数
+    static size_t buildRemap(const std::vector<Vertex>& vertices, std::vector<unsigned int>& remap, float epsilon = 0.0f)
+    {
+        const size_t count = vertices.size();
+        remap.assign(count, 0);
+        if (count == 0)
+            return 0;
+
+        std::vector<uint32_t> keys(count * KEY_WORDS);
+        for (size_t i = 0; i < count; i++)
+            makeKey(vertices[i], epsilon, &keys[i * KEY_WORDS]);
+
+        // 表大小取不小于 2 倍顶点数的 2 的幂，装载因子不超过 0.5
+        size_t tableSize = 1;
+        while (tableSize < count * 2)
+            tableSize <<= 1;
+        const unsigned int EMPTY = 0xFFFFFFFFu;
+        std::vector<unsigned int> table(tableSize, EMPTY);     // 存放代表顶点的原下标
+
+        size_t unique = 0;
+        for (size_t i = 0; i < count; i++) {
+            const uint32_t* key = &keys[i * KEY_WORDS];
+            size_t slot = hashKey(key) & (tableSize - 1);
+            for (size_t probe = 1; ; probe++) {
+                unsigned int entry = table[slot];
+                if (entry == EMPTY) {
+                    table[slot] = (unsigned int)i;
+                    remap[i] = (unsigned int)unique++;
+                    break;
+                }
+                if (std::memcmp(&keys[entry * KEY_WORDS], key, KEY_WORDS * sizeof(uint32_t)) == 0) {
+                    remap[i] = remap[entry];
+                    break;
+                }
+                slot = (slot + probe) & (tableSize - 1);    // 三角数探测，2 的幂大小时能遍历所有槽
+            }
+        }
+        return unique;
+    }
+
+private:
+    static void makeKey(const Vertex& vertex, float epsilon, uint32_t* key)
+    {
+        size_t n = 0;
+        auto put = [&](float value) {
+            key[n++] = quantize(value, epsilon);
+        };
+        put(vertex.position.x);  put(vertex.position.y);  put(vertex.position.z);
+        put(vertex.normal.x);    put(vertex.normal.y);    put(vertex.normal.z);
+        put(vertex.texCoord.x);  put(vertex.texCoord.y);
+        put(vertex.color.x);     put(vertex.color.y);     put(vertex.color.z);
+        put(vertex.tangent.x);   put(vertex.tangent.y);   put(vertex.tangent.z);
+        put(vertex.bitangent.x); put(vertex.bitangent.y); put(vertex.bitangent.z);
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+            key[n++] = (uint32_t)vertex.m_BoneIDs[i];
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+            put(vertex.m_Weights[i]);
+    }
+
+    static uint32_t quantize(float value, float epsilon)
+    {
+        if (epsilon > 0.0f) {
+            // 以 double 计算并夹到 int32 范围内再转换，超出范围的值（以及 NaN）落在两端的格子里
+            double cell = std::floor((double)value / epsilon + 0.5);
+            if (!(cell > (double)INT32_MIN))
+                cell = (double)INT32_MIN;
+            else if (cell > (double)INT32_MAX)
+                cell = (double)INT32_MAX;
+            return (uint32_t)(int32_t)cell;
+        }
+        value += 0.0f;      // 将 -0.0 归一为 +0.0
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    // 按 32 位字做 FNV-1a，最后用 MurmurHash3 的 fmix32 打散，表下标只取低位
+    static size_t hashKey(const uint32_t* key)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < KEY_WORDS; i++) {
+            hash ^= key[i];
+            hash *= 16777619u;
+        }
+        hash ^= hash >> 16;
+        hash *= 0x85EBCA6Bu;
+        hash ^= hash >> 13;
+        hash *= 0xC2B2AE35u;
+        hash ^= hash >> 16;
+        return hash;
+    }
+};
+
+#endif
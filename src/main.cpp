@@ -21,10 +21,19 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <chrono>
 
 #include <stb_image.h>
 
 #include "Shader/Shader.h"
+#include "Shader/ShaderLoader.h"
+#include "Shader/ShaderVariants.h"
+#include "Render/FrameUniforms.h"
+#include "Render/UniformRing.h"
+#include "Render/GeometryArena.h"
+#include "Render/MultiDrawBatch.h"
+#include "Render/BonePaletteBuffer.h"
+#include "Animation/PoseEvaluator.h"
 #include "Struct/Vertex.h"
 #include "Struct/Mesh.h"
 #include "Struct/Cuboid.h"
@@ -44,6 +53,9 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void printOperationTips();
 unsigned int loadTexture(char const * path);
 unsigned int loadCubemap(vector<std::string> faces);
+void benchmarkUniformUpload(const Shader& shader, const glm::vec2* translations, int count);
+void benchmarkDrawSubmission(int meshCount);
+void benchmarkAnimation(int characterCount);
 
 // window 设置
 const unsigned int SCR_WIDTH = 800;
@@ -90,6 +102,10 @@ bool is_lightColorChange = false;
 bool is_renderBorder = true;
 bool is_faceCulling = false;
 bool is_renderNormal = false;
+bool is_benchmarkUniform = false;
+bool is_benchmarkDraw = false;
+bool is_benchmarkAnimation = false;
+bool is_printGLState = false;
 
 int lastLState = GLFW_RELEASE;
 int lastEState = GLFW_RELEASE;
@@ -98,6 +114,10 @@ int lastCState = GLFW_RELEASE;
 int lastBState = GLFW_RELEASE;
 int lastQState = GLFW_RELEASE;
 int lastNState = GLFW_RELEASE;
+int lastPState = GLFW_RELEASE;
+int lastGState = GLFW_RELEASE;
+int lastMState = GLFW_RELEASE;
+int lastKState = GLFW_RELEASE;
 
 int main()
 {
@@ -140,8 +160,9 @@ int main()
     }
 
     // 启用混合绘制
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLStateCache& glState = GLStateCache::instance();
+    glState.setBlend(true);
+    glState.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
     // ------------------------------------------------------------------
@@ -411,6 +432,14 @@ int main()
     // stbi_set_flip_vertically_on_load(true);
     // // load model
     // Model ourModel(MODEL_PATH("backpack/backpack.obj"));
+    // MeshOptions meshOptions;
+    // meshOptions.vertexFormat = VertexFormat::PACKED;     // 量化顶点，加载时输出显存节省
+    // meshOptions.positionStream = true;                   // 深度预渲染/阴影通道只拉取位置
+    // meshOptions.splitLargeMeshes = true;                 // 超过 65536 个顶点的网格拆分，全部使用 16 位索引
+    // meshOptions.useArena = true;                         // 所有子网格共用 GeometryArena 的缓冲与 VAO
+    // meshOptions.meshlets = true;                         // 分簇，绘制时用 ourModel.renderCulled(shader, MeshletCuller::create(...)) 剔除不可见的簇
+    // meshOptions.lodChain = true;                         // 简化的细节级别，绘制时用 ourModel.renderLod(shader, LodSelector::create(...))
+    // Model ourModel(MODEL_PATH("backpack/backpack.obj"), false, meshOptions);
     // Model ourModel(MODEL_PATH("nanosuit_reflection/nanosuit.obj"));
 
     // framebuffer configuration
@@ -442,52 +471,65 @@ int main()
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
     // uniform buffer
-    // 1. create uniform buffer object and allocate memory
-    unsigned int uboMatrices;
-    glGenBuffers(1, &uboMatrices);
-    
-    glBindBuffer(GL_UNIFORM_BUFFER, uboMatrices);
-    glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), NULL, GL_STATIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-
-    glBindBufferRange(GL_UNIFORM_BUFFER, 0, uboMatrices, 0, 2 * sizeof(glm::mat4));
+    // 相机与物体的 uniform 块每帧写入环形缓冲，三帧轮换，不再用 glBufferSubData 覆盖 GPU 可能仍在读取的缓冲
+    UniformRing uniformRing;
+    uniformRing.init(64 * 1024);
 
 
     // create Shader
-
-    Shader shader("instance_shader.vs", "Shader.fs");
-    Shader normalShader("geometryShader.vs", "geometryShader.fs", "check_normal.gs");
-    normalShader.use();
-    normalShader.setFloat("normal_offset", NORMAL_OFFSET);
+    // 所有着色器的 Matrices / Object 块在链接时自动绑定到固定绑定点
+    UniformBlockBindings::set("Matrices", CAMERA_BLOCK_BINDING);
+    UniformBlockBindings::set("Object", OBJECT_BLOCK_BINDING);
+
+    // 启用程序二进制缓存，第二次启动起直接加载驱动编译好的程序
+    ProgramBinaryCache::instance().setDirectory("shader_cache");
+    // 启用烘焙网格缓存，模型第二次加载起映射缓存文件直接上传，不再运行 assimp
+    MeshCache::instance().setDirectory("mesh_cache");
+
+    // 着色器源码在构建时内嵌，不依赖工作目录；调试时可设置环境变量 SHADER_OVERRIDE_DIR 指向 include/Shader 直接修改源码
+    // 异步创建：源码在工作线程读取，编译在驱动中并行进行，主循环不必等待所有程序就绪
+    ShaderLoader shaderLoader;
+    ShaderHandle shaderHandle = shaderLoader.load("instance_shader.vs", "Shader.fs");
+    ShaderHandle normalShaderHandle = shaderLoader.load("geometryShader.vs", "geometryShader.fs", "check_normal.gs");
+
+    // offsets 数组在运行期间不变，程序就绪后整体上传一次
+    shaderHandle.onReady([&translations](Shader& shader) {
+        shader.use();
+        shader.setVec2Array("offsets", translations, 100);
+    });
+    // 法线可视化程序的矩阵全部来自 uniform 块，这里只需设置一次线段长度
+    normalShaderHandle.onReady([](Shader& normalShader) {
+        normalShader.use();
+        normalShader.setFloat("normal_offset", NORMAL_OFFSET);
+    });
+    bool shaderStatsPrinted = false;
     
     // 2. bind Shader's uniform block to binding point
     // 将 各着色器的 uniform 块绑定到绑定点 0 上
-    // Shader shaderRed("uniformBufferShader.vs", "Shader_Red.fs");
-    // Shader shaderGreen("uniformBufferShader.vs", "Shader_Green.fs");
-    // Shader shaderBlue("uniformBufferShader.vs", "Shader_Blue.fs");
-    // Shader shaderYellow("uniformBufferShader.vs", "Shader_Other.fs");
-
-    // unsigned int uniformBlockIndexRed    = glGetUniformBlockIndex(shaderRed.ID, "Matrices");
-    // unsigned int uniformBlockIndexGreen  = glGetUniformBlockIndex(shaderGreen.ID, "Matrices");
-    // unsigned int uniformBlockIndexBlue   = glGetUniformBlockIndex(shaderBlue.ID, "Matrices");
-    // unsigned int uniformBlockIndexYellow = glGetUniformBlockIndex(shaderYellow.ID, "Matrices");  
-
-    // glUniformBlockBinding(shaderRed.ID,    uniformBlockIndexRed, 0);
-    // glUniformBlockBinding(shaderGreen.ID,  uniformBlockIndexGreen, 0);
-    // glUniformBlockBinding(shaderBlue.ID,   uniformBlockIndexBlue, 0);
-    // glUniformBlockBinding(shaderYellow.ID, uniformBlockIndexYellow, 0);
-
-
-    // 3. bind the uniform buffer to binding point
-    // 4. add data to the uniform buffer
-    // 填充了投影矩阵到 uniform 缓冲区中，并且将其绑定到绑定点 0 上
-    glm::mat4 projection = glm::perspective(glm::radians(camera.zoom_), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-    glBindBuffer(GL_UNIFORM_BUFFER, uboMatrices);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(projection));
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    // 四种颜色是同一份 Shader_Color.fs 的宏变体，场景加载时预编译
+    ShaderVariantCache shaderVariants;
+    std::vector<ShaderVariantDesc> colorManifest = {
+        { "uniformBufferShader.vs", "Shader_Color.fs", "", { { "COLOR", "vec3(1.0, 0.0, 0.0)" } } },
+        { "uniformBufferShader.vs", "Shader_Color.fs", "", { { "COLOR", "vec3(0.0, 1.0, 0.0)" } } },
+        { "uniformBufferShader.vs", "Shader_Color.fs", "", { { "COLOR", "vec3(0.0, 0.0, 1.0)" } } },
+        { "uniformBufferShader.vs", "Shader_Color.fs", "", { { "COLOR", "vec3(1.0, 1.0, 0.0)" } } },
+    };
+    shaderVariants.prewarm(colorManifest);
+    Shader* cubeShaders[4];
+    for (int i = 0; i < 4; i++)
+        cubeShaders[i] = &shaderVariants.get(colorManifest[i]);
+    const glm::vec3 cubeOffsets[4] = {
+        glm::vec3(-0.75f,  0.75f, 0.0f), glm::vec3(0.75f,  0.75f, 0.0f),
+        glm::vec3(-0.75f, -0.75f, 0.0f), glm::vec3(0.75f, -0.75f, 0.0f)
+    };
+
+    // uniform 块 Matrices / Object 已在着色器链接时按名称绑定，无需再逐个调用 glUniformBlockBinding
 
     printOperationTips();
 
+    // 初始化阶段直接调用了 glBind*，进入主循环前同步影子状态
+    glState.invalidate();
+
     // 渲染主循环
     // -----------
     while (!glfwWindowShouldClose(window))
@@ -495,90 +537,98 @@ int main()
         float currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
+        glState.beginFrame();
+        if (is_printGLState) {
+            glState.printStats();
+            uniformRing.printStats();
+            GeometryArena::instance().printStats();
+            is_printGLState = false;
+        }
 
         // 输入
         // -----
         processInput(window);
 
+        // 推进着色器异步创建，全部完成后输出一次缓存命中统计
+        shaderLoader.update();
+        if (!shaderStatsPrinted && shaderLoader.idle()) {
+            ProgramBinaryCache::instance().printStats();
+            shaderStatsPrinted = true;
+        }
+
         // render
         // ------
 
         // 阶段一：
         // 进行离屏渲染，将立方体和结果渲染到 framebuffer 上
         // glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
-        glEnable(GL_DEPTH_TEST);
-        glDisable(GL_CULL_FACE);
+        glState.setDepthTest(true);
+        glState.setCullFace(false);
 
         glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // view 矩阵设定
-        // 3. bind the uniform buffer to binding point
-        // 4. add data to the uniform buffer
-        glm::mat4 view = camera.GetViewMatrix();
-        glBindBuffer(GL_UNIFORM_BUFFER, uboMatrices);
-        glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), sizeof(glm::mat4), glm::value_ptr(view));
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        // 本帧的 uniform 块：先写入相机和物体数据，一次 flush 后再绑定区间绘制
+        uniformRing.beginFrame();
+
+        CameraUniforms cameraUniforms;
+        cameraUniforms.projection = glm::perspective(glm::radians(camera.zoom_), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+        cameraUniforms.view = camera.GetViewMatrix();
+        UniformRing::Allocation cameraBlock = uniformRing.push(cameraUniforms);
 
-        glBindVertexArray(quadVAO);
         glm::mat4 model = glm::mat4(1.0f);
+        ObjectUniforms quadUniforms;
+        quadUniforms.model = model;
+        quadUniforms.normalMatrix = glm::mat4(glm::mat3(glm::transpose(glm::inverse(cameraUniforms.view * model))));
+        UniformRing::Allocation quadBlock = uniformRing.push(quadUniforms);
+
+        UniformRing::Allocation cubeBlocks[4];
+        for (int i = 0; i < 4; i++) {
+            glm::mat4 cubeModel = glm::translate(glm::mat4(1.0f), cubeOffsets[i]);
+            cubeBlocks[i] = uniformRing.push(ObjectUniforms{ cubeModel, glm::mat4(glm::mat3(glm::transpose(glm::inverse(cameraUniforms.view * cubeModel)))) });
+        }
+
+        uniformRing.flush();
+        uniformRing.bind(CAMERA_BLOCK_BINDING, cameraBlock);
+
+        glState.bindVertexArray(quadVAO);
         
-        shader.use();
-        for(unsigned int i = 0; i < 100; i++) {
-            shader.setVec2(("offsets[" + std::to_string(i) + "]"), translations[i]);
+        if (shaderHandle.ready()) {
+            Shader& shader = shaderHandle.get();
+            if (is_benchmarkUniform) {
+                benchmarkUniformUpload(shader, translations, 100);
+                is_benchmarkUniform = false;
+            }
+            if (is_benchmarkDraw) {
+                benchmarkDrawSubmission(4096);
+                // 基准绑定过其他 VAO 并删除了临时网格，重新绑定四边形的 VAO
+                glState.bindVertexArray(quadVAO);
+                is_benchmarkDraw = false;
+            }
+            if (is_benchmarkAnimation) {
+                benchmarkAnimation(1000);
+                is_benchmarkAnimation = false;
+            }
+
+            shader.use();
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 6, 100);
         }
-        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, 100);
 
-        if (is_renderNormal) {
+        if (is_renderNormal && normalShaderHandle.ready()) {
+            Shader& normalShader = normalShaderHandle.get();
             normalShader.use();
-            glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(view * model)));
-            normalShader.setMat4("projection", projection);
-            normalShader.setMat4("view", view);
-            normalShader.setMat4("model", model);
-            normalShader.setMat3("normalMatrix", normalMatrix);
+            uniformRing.bind(OBJECT_BLOCK_BINDING, quadBlock);
             glDrawArrays(GL_TRIANGLES, 0, 6);            
         }
 
-        glBindVertexArray(0);
-
-
-        // // Red cube
-        // shaderRed.use();
-        // model = glm::translate(model, glm::vec3(-0.75f, 0.75f, 0.0f));
-        // normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
-        // shaderRed.setMat4("model", model);
-        // shaderRed.setMat4("normalMatrix", normalMatrix);
-        // glDrawArrays(GL_TRIANGLES, 0, 36);
-        
-
-        // // Green cube
-        // shaderGreen.use();
-        // model = glm::mat4(1.0f);
-        // model = glm::translate(model, glm::vec3(0.75f, 0.75f, 0.0f));
-        // normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
-        // shaderGreen.setMat4("model", model);
-        // shaderGreen.setMat4("normalMatrix", normalMatrix);
-        // glDrawArrays(GL_TRIANGLES, 0, 36);
-
-
-        // // Blue cube
-        // shaderBlue.use();
-        // model = glm::mat4(1.0f);
-        // model = glm::translate(model, glm::vec3(-0.75f, -0.75f, 0.0f));
-        // normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
-        // shaderBlue.setMat4("model", model);
-        // shaderBlue.setMat4("normalMatrix", normalMatrix);
-        // glDrawArrays(GL_TRIANGLES, 0, 36);
-        
 
-        // // Yellow cube
-        // shaderYellow.use();
-        // model = glm::mat4(1.0f);
-        // model = glm::translate(model, glm::vec3(0.75f, -0.75f, 0.0f));
-        // normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
-        // shaderYellow.setMat4("model", model);
-        // shaderYellow.setMat4("normalMatrix", normalMatrix);
-        // glDrawArrays(GL_TRIANGLES, 0, 36);
+        // 四个颜色立方体，着色器为启动时预编译的变体
+        glState.bindVertexArray(cubeVAO);
+        for (int i = 0; i < 4; i++) {
+            cubeShaders[i]->use();
+            uniformRing.bind(OBJECT_BLOCK_BINDING, cubeBlocks[i]);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
 
         // glBindVertexArray(0);
 
@@ -613,6 +663,9 @@ int main()
         // glBindTexture(GL_TEXTURE_2D, textureColorBuffer);
         // glDrawArrays(GL_TRIANGLES, 0, 6);
 
+        // 本帧使用环形缓冲的绘制已全部提交，放置栅栏
+        uniformRing.endFrame();
+
         // glfw: 交换缓冲区并拉取 IO 事件
         // -------------------------------------------------------------------------------
         glfwSwapBuffers(window);
@@ -633,6 +686,8 @@ int main()
     glDeleteBuffers(1, &pointVBO);
     glDeleteRenderbuffers(1, &rbo);
     glDeleteFramebuffers(1, &framebuffer);
+    uniformRing.destroy();
+    GeometryArena::instance().destroy();
 
     // glfw: 终止
     // -----------------
@@ -704,6 +759,30 @@ void processInput(GLFWwindow *window)
         is_renderNormal = !is_renderNormal;
     }
     lastNState = currentNState;
+
+    int currentPState = glfwGetKey(window, GLFW_KEY_P);
+    if (lastPState == GLFW_RELEASE && currentPState == GLFW_PRESS) {
+        is_benchmarkUniform = true;
+    }
+    lastPState = currentPState;
+
+    int currentGState = glfwGetKey(window, GLFW_KEY_G);
+    if (lastGState == GLFW_RELEASE && currentGState == GLFW_PRESS) {
+        is_printGLState = true;
+    }
+    lastGState = currentGState;
+
+    int currentMState = glfwGetKey(window, GLFW_KEY_M);
+    if (lastMState == GLFW_RELEASE && currentMState == GLFW_PRESS) {
+        is_benchmarkDraw = true;
+    }
+    lastMState = currentMState;
+
+    int currentKState = glfwGetKey(window, GLFW_KEY_K);
+    if (lastKState == GLFW_RELEASE && currentKState == GLFW_PRESS) {
+        is_benchmarkAnimation = true;
+    }
+    lastKState = currentKState;
 }
 
 // glfw: 每当窗口大小发生变化（由操作系统或用户自行调整）时，此回调函数就会执行。
@@ -765,6 +844,10 @@ void printOperationTips()
     // std::cout << "  B - 切换是否显示边框" << std::endl;
     // std::cout << "  Q - 切换是否正面剔除" << std::endl;
     std::cout << "  N - 切换是否渲染法向量" << std::endl;
+    std::cout << "  P - 测试 uniform 上传耗时" << std::endl;
+    std::cout << "  G - 输出上一帧 GL 调用统计" << std::endl;
+    std::cout << "  M - 测试绘制提交耗时" << std::endl;
+    std::cout << "  K - 测试骨骼动画求值耗时" << std::endl;
     std::cout << std::endl;
     
     std::cout << "其他:" << std::endl;
@@ -844,4 +927,271 @@ unsigned int loadCubemap(vector<std::string> faces)
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
     return textureID;
-}
\ No newline at end of file
+}
+
+// uniform 上传微基准：对比每次绘制上传 offsets[100] 的三种方式
+// 1. 旧方式：逐元素拼接名称 + glGetUniformLocation
+// 2. 缓存方式：逐元素拼接名称 + 哈希表查询
+// 3. 数组方式：一次 glUniform2fv 上传整个数组
+// ---------------------------------------------------
+void benchmarkUniformUpload(const Shader& shader, const glm::vec2* translations, int count)
+{
+    const int DRAWS = 1000;
+    using clock = std::chrono::high_resolution_clock;
+    shader.use();
+
+    auto start = clock::now();
+    for (int draw = 0; draw < DRAWS; draw++) {
+        for (int i = 0; i < count; i++) {
+            std::string name = "offsets[" + std::to_string(i) + "]";
+            glUniform2fv(glGetUniformLocation(shader.ID, name.c_str()), 1, &translations[i][0]);
+        }
+    }
+    glFinish();
+    double legacy = std::chrono::duration<double, std::nano>(clock::now() - start).count() / DRAWS;
+
+    start = clock::now();
+    for (int draw = 0; draw < DRAWS; draw++) {
+        char name[32];
+        for (int i = 0; i < count; i++) {
+            std::snprintf(name, sizeof(name), "offsets[%d]", i);
+            shader.setVec2(name, translations[i]);
+        }
+    }
+    glFinish();
+    double cached = std::chrono::duration<double, std::nano>(clock::now() - start).count() / DRAWS;
+
+    start = clock::now();
+    for (int draw = 0; draw < DRAWS; draw++) {
+        shader.setVec2Array("offsets", translations, count);
+    }
+    glFinish();
+    double array = std::chrono::duration<double, std::nano>(clock::now() - start).count() / DRAWS;
+
+    std::cout << "uniform 上传耗时（每次绘制, " << count << " 个 vec2）:" << std::endl;
+    std::cout << "  glGetUniformLocation: " << legacy << " ns" << std::endl;
+    std::cout << "  location 缓存:        " << cached << " ns" << std::endl;
+    std::cout << "  整体数组上传:         " << array  << " ns" << std::endl;
+}
+
+// 绘制提交微基准：meshCount 个小立方体子网格，对比三种提交方式的 CPU 耗时
+// 1. 每个网格独立的 VAO/VBO/EBO，逐个 glDrawElements
+// 2. 共享 GeometryArena 的缓冲与 VAO，逐个 glDrawElementsBaseVertex
+// 3. MultiDrawBatch：一次 glMultiDrawElementsIndirect（GL 3.3 下为每组一次绑定的循环）
+// 三者使用同一个 drawBatch.vs 程序，立方体排成网格，模型矩阵按 drawId 从纹理缓冲读取
+// （前两种方式没有 drawId 属性，只比较提交开销）
+// 只统计提交调用本身，glFinish 不计入；开启光栅化丢弃，不影响画面
+// ---------------------------------------------------
+void benchmarkDrawSubmission(int meshCount)
+{
+    const int FRAMES = 20;
+    const int COLUMNS = 64;
+    using clock = std::chrono::high_resolution_clock;
+    GLStateCache& state = GLStateCache::instance();
+
+    std::vector<Vertex> vertices;
+    for (int i = 0; i < 8; i++) {
+        glm::vec3 corner((i & 1) ? 0.01f : -0.01f, (i & 2) ? 0.01f : -0.01f, (i & 4) ? 0.01f : -0.01f);
+        vertices.emplace_back(corner, glm::normalize(corner));
+    }
+    std::vector<unsigned int> indices = {
+        0, 2, 1, 1, 2, 3,   4, 5, 6, 5, 7, 6,   0, 1, 4, 1, 5, 4,
+        2, 6, 3, 3, 6, 7,   0, 4, 2, 2, 4, 6,   1, 3, 5, 3, 7, 5
+    };
+    uint32_t attributes = VertexLayout::POSITION_BIT | VertexLayout::NORMAL_BIT;
+
+    MeshOptions separateOptions;
+    MeshOptions arenaOptions;
+    arenaOptions.useArena = true;
+    std::vector<Mesh> separate;
+    std::vector<Mesh> pooled;
+    separate.reserve(meshCount);
+    pooled.reserve(meshCount);
+    for (int i = 0; i < meshCount; i++) {
+        separate.emplace_back(vertices, indices, std::vector<Texture>(), separateOptions, attributes);
+        pooled.emplace_back(vertices, indices, std::vector<Texture>(), arenaOptions, attributes);
+    }
+    MultiDrawBatch batch;
+    batch.build(pooled);
+
+    // 逐绘制模型矩阵：第 i 个网格（drawId = i）平移到网格中的第 i 格
+    std::vector<glm::vec4> transforms(meshCount * 3);
+    for (int i = 0; i < meshCount; i++) {
+        glm::vec3 offset = glm::vec3((float)(i % COLUMNS), (float)(i / COLUMNS), 0.0f) * 0.03f - glm::vec3(0.96f, 0.96f, 0.0f);
+        transforms[i * 3 + 0] = glm::vec4(1.0f, 0.0f, 0.0f, offset.x);
+        transforms[i * 3 + 1] = glm::vec4(0.0f, 1.0f, 0.0f, offset.y);
+        transforms[i * 3 + 2] = glm::vec4(0.0f, 0.0f, 1.0f, offset.z);
+    }
+    GLuint transformBuffer, transformTexture;
+    glGenBuffers(1, &transformBuffer);
+    state.bindBuffer(GL_TEXTURE_BUFFER, transformBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, transforms.size() * sizeof(glm::vec4), transforms.data(), GL_STATIC_DRAW);
+    glGenTextures(1, &transformTexture);
+
+    Shader shader("drawBatch.vs", "Shader_Color.fs");
+    GLint unit = shader.samplerUnit("drawTransforms");
+    state.bindTexture(unit < 0 ? 0 : (GLuint)unit, GL_TEXTURE_BUFFER, transformTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, transformBuffer);
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    shader.use();
+    glFinish();
+
+    auto start = clock::now();
+    for (int frame = 0; frame < FRAMES; frame++)
+        for (const Mesh& mesh : separate)
+            mesh.render(shader);
+    double perMesh = std::chrono::duration<double, std::micro>(clock::now() - start).count() / FRAMES;
+    glFinish();
+
+    start = clock::now();
+    for (int frame = 0; frame < FRAMES; frame++)
+        for (const Mesh& mesh : pooled)
+            mesh.render(shader);
+    double arena = std::chrono::duration<double, std::micro>(clock::now() - start).count() / FRAMES;
+    glFinish();
+
+    start = clock::now();
+    for (int frame = 0; frame < FRAMES; frame++)
+        batch.render(shader, pooled);
+    double multiDraw = std::chrono::duration<double, std::micro>(clock::now() - start).count() / FRAMES;
+    glFinish();
+
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    glDeleteProgram(shader.ID);
+    state.programDeleted(shader.ID);
+    glDeleteTextures(1, &transformTexture);
+    state.textureDeleted(transformTexture);
+    glDeleteBuffers(1, &transformBuffer);
+    state.bufferDeleted(transformBuffer);
+
+    std::cout << "绘制提交耗时（每帧, " << meshCount << " 个子网格）:" << std::endl;
+    std::cout << "  独立 VAO 逐个绘制:    " << perMesh << " us" << std::endl;
+    std::cout << "  共享缓冲逐个绘制:     " << arena << " us" << std::endl;
+    std::cout << "  " << (batch.multiDraw() ? "多重间接绘制:         " : "分组循环（GL 3.3）:   ")
+              << multiDraw << " us (" << batch.groupCount() << " 组)" << std::endl;
+}
+
+// 骨骼动画微基准：characterCount 个角色共用一个 64 根骨骼的骨架与两个片段，
+// 每个角色播放时间不同，四分之一的角色在两个片段之间混合
+// 1. 单线程求值  2. 线程池并行求值  3. 全部调色板一次上传到纹理缓冲
+// ---------------------------------------------------
+void benchmarkAnimation(int characterCount)
+{
+    const int FRAMES = 20;
+    const int BONES = 64;
+    const int CHAINS = 4;
+    using clock = std::chrono::high_resolution_clock;
+
+    // 根节点下 4 条长度为 16 的骨骼链
+    Skeleton skeleton;
+    for (int i = 0; i < BONES; i++)
+        skeleton.addBone("bone" + std::to_string(i), glm::mat4(1.0f));
+    for (int i = 0; i < BONES; i++) {
+        glm::mat4 bindLocal = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.1f, 0.0f));
+        skeleton.addNode("bone" + std::to_string(i), i == 0 ? -1 : (i <= CHAINS ? 0 : i - CHAINS), bindLocal);
+    }
+
+    // 每个节点 5 个旋转关键帧，绕各自的轴来回摆动
+    AnimationClipStore clips;
+    const char* names[2] = { "walk", "run" };
+    const float durations[2] = { 1.0f, 0.8f };
+    for (int c = 0; c < 2; c++) {
+        std::vector<AnimationClip::SourceChannel> channels(skeleton.nodeCount());
+        for (size_t n = 0; n < channels.size(); n++) {
+            glm::vec3 axis = glm::normalize(glm::vec3((float)(n % 3), 1.0f, (float)(n % 5)));
+            for (int k = 0; k <= 4; k++) {
+                float time = durations[c] * k / 4.0f;
+                float angle = 0.5f * std::sin(glm::pi<float>() * 0.5f * k + (float)n + c);
+                channels[n].rotationTimes.push_back(time);
+                channels[n].rotations.push_back(glm::vec4(axis * std::sin(angle * 0.5f), std::cos(angle * 0.5f)));
+            }
+        }
+        clips.add(AnimationClip::resample(names[c], durations[c], channels, skeleton));
+    }
+
+    std::vector<AnimationInstance> instances(characterCount);
+    for (int i = 0; i < characterCount; i++) {
+        instances[i].clip = i % 2;
+        instances[i].time = 0.013f * i;
+        if (i % 4 == 0) {
+            instances[i].blendClip = 1 - instances[i].clip;
+            instances[i].blendTime = 0.007f * i;
+            instances[i].blendWeight = 0.5f;
+        }
+    }
+
+    PoseEvaluator evaluator(skeleton, clips);
+    std::vector<float> palettes;
+    evaluator.evaluateAll(instances, palettes, nullptr);    // 预热，分配调色板与每线程临时缓冲
+
+    auto advance = [&instances]() {
+        for (AnimationInstance& instance : instances) {
+            instance.time += 1.0f / 60.0f;
+            instance.blendTime += 1.0f / 60.0f;
+        }
+    };
+
+    auto start = clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        advance();
+        evaluator.evaluateAll(instances, palettes, nullptr);
+    }
+    double serial = std::chrono::duration<double, std::milli>(clock::now() - start).count() / FRAMES;
+
+    ThreadPool& pool = ThreadPool::instance();
+    start = clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        advance();
+        evaluator.evaluateAll(instances, palettes, &pool);
+    }
+    double parallel = std::chrono::duration<double, std::milli>(clock::now() - start).count() / FRAMES;
+
+    // 同样的片段压缩后再测一遍：只采样（不建调色板）的吞吐，以及完整的单线程求值
+    AnimationClipStore compressedClips = clips;
+    compressedClips.compress();
+    PoseEvaluator compressedEvaluator(skeleton, compressedClips);
+    std::vector<float> pose((size_t)AnimationClip::COMPONENT_COUNT * clips[0].stride);
+    auto samplingRate = [&](const PoseEvaluator& target) {
+        auto begin = clock::now();
+        for (int frame = 0; frame < FRAMES; frame++) {
+            advance();
+            for (const AnimationInstance& instance : instances)
+                target.sampleClip(instance.clip, instance.time, pose.data());
+        }
+        return (double)FRAMES * characterCount / std::chrono::duration<double, std::milli>(clock::now() - begin).count();
+    };
+    double rawSampling = samplingRate(evaluator);
+    double compressedSampling = samplingRate(compressedEvaluator);
+
+    compressedEvaluator.evaluateAll(instances, palettes, nullptr);
+    start = clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        advance();
+        compressedEvaluator.evaluateAll(instances, palettes, nullptr);
+    }
+    double compressedSerial = std::chrono::duration<double, std::milli>(clock::now() - start).count() / FRAMES;
+
+    BonePaletteBuffer paletteBuffer;
+    paletteBuffer.init((size_t)characterCount * BONES);
+    glFinish();
+    start = clock::now();
+    for (int frame = 0; frame < FRAMES; frame++)
+        paletteBuffer.upload(palettes.data(), (size_t)characterCount * BONES);
+    glFinish();
+    double upload = std::chrono::duration<double, std::milli>(clock::now() - start).count() / FRAMES;
+    paletteBuffer.destroy();
+
+    std::cout << "骨骼动画耗时（每帧, " << characterCount << " 个角色, " << BONES << " 根骨骼, "
+              << clips.memoryBytes() / 1024.0f << " KB 片段数据）:" << std::endl;
+    std::cout << "  单线程求值:           " << serial << " ms" << std::endl;
+    std::cout << "  线程池求值（" << pool.threadCount() + 1 << " 线程）:  " << parallel << " ms" << std::endl;
+    std::cout << "  调色板上传:           " << upload << " ms ("
+              << palettes.size() * sizeof(float) / 1024.0f << " KB)" << std::endl;
+    std::cout << "  压缩片段:             " << clips.memoryBytes() / 1024.0f << " KB -> "
+              << compressedClips.memoryBytes() / 1024.0f << " KB" << std::endl;
+    compressedClips.printStats();
+    std::cout << "  采样吞吐（姿态/ms）:  原始 " << rawSampling << ", 压缩 " << compressedSampling << std::endl;
+    std::cout << "  单线程求值（压缩）:   " << compressedSerial << " ms" << std::endl;
+}